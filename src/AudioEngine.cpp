@@ -0,0 +1,101 @@
+#include "AudioEngine.h"
+#include <algorithm>
+#include <iostream>
+
+AudioEngine::AudioEngine() {}
+
+AudioEngine::~AudioEngine() {
+    shutdown();
+}
+
+bool AudioEngine::init() {
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+        return false;
+    }
+
+    SDL_AudioSpec desired;
+    SDL_memset(&desired, 0, sizeof(desired));
+    desired.freq = Music::DEFAULT_SAMPLE_RATE;
+    desired.format = AUDIO_F32SYS;
+    desired.channels = 1;
+    desired.samples = BUFFER_SAMPLES;
+    desired.callback = audioCallback;
+    desired.userdata = this;
+
+    audioDevice_ = SDL_OpenAudioDevice(nullptr, 0, &desired, &audioSpec_,
+                                       SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_CHANNELS_CHANGE);
+    if (audioDevice_ == 0) {
+        return false;
+    }
+
+    // The device starts paused, so the sources can be set up for it here
+    mixer_.setSampleRate(audioSpec_.freq);
+    if (audioSpec_.channels > 1) {
+        monoBuffer_.assign(audioSpec_.samples, 0.0f);
+    }
+
+    SDL_PauseAudioDevice(audioDevice_, 0); // Start audio
+    return true;
+}
+
+void AudioEngine::shutdown() {
+    if (audioDevice_ != 0) {
+        SDL_CloseAudioDevice(audioDevice_);
+        audioDevice_ = 0;
+    }
+
+    // The callback has stopped, so the loop can be unmapped
+    if (cacheThread_.joinable()) {
+        cacheThread_.join();
+    }
+    music_.setLoop(nullptr);
+    musicCache_.close();
+}
+
+void AudioEngine::startMusicCache(const std::string& path) {
+    if (cacheThread_.joinable()) {
+        return;
+    }
+
+    cacheThread_ = std::thread([this, path] {
+        if (musicCache_.open(path, music_.sampleRate())) {
+            music_.setLoop(musicCache_.samples());
+        } else {
+            std::cerr << "Music cache " << path << " unavailable, synthesising live" << std::endl;
+        }
+    });
+}
+
+void AudioEngine::render(float* out, int frames) {
+    int channels = audioSpec_.channels;
+    if (channels <= 1) {
+        mixer_.render(out, frames);
+        return;
+    }
+
+    // Same signal on every channel
+    int chunkSize = static_cast<int>(monoBuffer_.size());
+    for (int done = 0; done < frames; done += chunkSize) {
+        int count = std::min(chunkSize, frames - done);
+        mixer_.render(monoBuffer_.data(), count);
+        for (int i = 0; i < count; i++) {
+            std::fill_n(out, channels, monoBuffer_[i]);
+            out += channels;
+        }
+    }
+}
+
+void AudioEngine::audioCallback(void* userdata, Uint8* stream, int len) {
+    AudioEngine* engine = static_cast<AudioEngine*>(userdata);
+    float* out = reinterpret_cast<float*>(stream);
+    int frames = len / static_cast<int>(sizeof(float) * engine->audioSpec_.channels);
+
+    if (!engine->stats_.enabled()) {
+        engine->render(out, frames);
+        return;
+    }
+
+    uint64_t start = AudioStats::nowNs();
+    engine->render(out, frames);
+    engine->stats_.record(start, AudioStats::nowNs() - start, frames, engine->audioSpec_.freq);
+}
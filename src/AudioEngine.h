@@ -0,0 +1,60 @@
+#pragma once
+
+#include "AudioStats.h"
+#include "Mixer.h"
+#include "Music.h"
+#include "MusicLoopCache.h"
+#include "Sound.h"
+#include <SDL.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Owns the game's one audio device. Music and sound effects share a single
+// callback that runs the Mixer, so there is one stream and one wakeup per
+// buffer instead of one per source.
+//
+// The device is opened at whatever rate and channel count it prefers, so
+// SDL never converts the stream; the mixer renders at that rate and the
+// mono mix is copied to every channel.
+class AudioEngine {
+public:
+    AudioEngine();
+    ~AudioEngine();
+
+    // Opens the default device. On failure the game carries on silently.
+    bool init();
+    void shutdown();
+
+    // Loads or renders the music loop cache at path on a worker thread and
+    // switches the track over to it once ready; until then, and if that
+    // fails, the music is synthesised live
+    void startMusicCache(const std::string& path);
+
+    Music& music() { return music_; }
+    Sound& sound() { return sound_; }
+    Mixer& mixer() { return mixer_; }
+
+    // Callback timing, off until enabled
+    AudioStats& stats() { return stats_; }
+
+    static constexpr int BUFFER_SAMPLES = 1024; // About 23 ms
+
+private:
+    static void audioCallback(void* userdata, Uint8* stream, int len);
+
+    // Fills frames interleaved frames of the device's format
+    void render(float* out, int frames);
+
+    Music music_;
+    Sound sound_;
+    Mixer mixer_{music_, sound_};
+    AudioStats stats_;
+
+    SDL_AudioDeviceID audioDevice_ = 0;
+    SDL_AudioSpec audioSpec_;
+    std::vector<float> monoBuffer_; // The mix before it is copied to each channel
+
+    MusicLoopCache musicCache_;
+    std::thread cacheThread_;
+};
@@ -0,0 +1,91 @@
+#include "AudioStats.h"
+#include <chrono>
+#include <cmath>
+
+void AudioStats::setEnabled(bool enabled) {
+    // The gap since the last callback seen is meaningless after a pause
+    lastStartNs_.store(0, std::memory_order_relaxed);
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void AudioStats::record(uint64_t startNs, uint64_t durationNs, int frames, int sampleRate) {
+    uint64_t deadlineNs = static_cast<uint64_t>(frames) * 1000000000ull / static_cast<uint64_t>(sampleRate);
+
+    increment(callbacks_);
+    increment(histogram_[bucketFor(durationNs)]);
+    if (durationNs > maxNs_.load(std::memory_order_relaxed)) {
+        maxNs_.store(durationNs, std::memory_order_relaxed);
+    }
+    if (durationNs > deadlineNs) {
+        increment(deadlineMisses_);
+    }
+
+    // Callbacks arrive once per buffer. With the callback API SDL doesn't
+    // report how much is queued, so a gap of one and a half buffers is
+    // taken to mean the device ran out.
+    uint64_t lastStart = lastStartNs_.load(std::memory_order_relaxed);
+    if (lastStart != 0 && startNs - lastStart > deadlineNs + deadlineNs / 2) {
+        increment(underruns_);
+    }
+    lastStartNs_.store(startNs, std::memory_order_relaxed);
+}
+
+AudioStats::Snapshot AudioStats::snapshot() const {
+    Snapshot result;
+    result.callbacks = callbacks_.load(std::memory_order_relaxed);
+    result.deadlineMisses = deadlineMisses_.load(std::memory_order_relaxed);
+    result.underruns = underruns_.load(std::memory_order_relaxed);
+    result.maxMs = static_cast<double>(maxNs_.load(std::memory_order_relaxed)) / 1e6;
+    for (int i = 0; i < BUCKETS; i++) {
+        result.histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+double AudioStats::Snapshot::percentileMs(double p) const {
+    uint64_t total = 0;
+    for (uint64_t count : histogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(p * static_cast<double>(total)));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen >= target && seen > 0) {
+            return bucketUpperMs(i);
+        }
+    }
+    return bucketUpperMs(BUCKETS - 1);
+}
+
+uint64_t AudioStats::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+int AudioStats::bucketFor(uint64_t durationNs) {
+    uint64_t us = durationNs / 1000;
+    if (us == 0) {
+        return 0;
+    }
+
+    // Octave, then which quarter of it
+    int octave = 0;
+    while (us >> (octave + 1)) {
+        octave++;
+    }
+    uint64_t quarter = (octave >= 2 ? us >> (octave - 2) : us << (2 - octave)) & 3;
+
+    int bucket = octave * 4 + static_cast<int>(quarter);
+    return bucket < BUCKETS ? bucket : BUCKETS - 1;
+}
+
+double AudioStats::bucketUpperMs(int bucket) {
+    int octave = bucket / 4;
+    int quarter = bucket % 4;
+    return std::ldexp(1.0 + (quarter + 1) / 4.0, octave) / 1000.0;
+}
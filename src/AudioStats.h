@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Timing of the audio callback: how long each one ran against its deadline
+// (the playing time of the buffer it filled), in a histogram, plus counts
+// of deadline misses and likely underruns. The audio thread writes with
+// plain atomic stores and never waits; any thread can take a snapshot.
+// While disabled the callback only pays for one relaxed load.
+//
+// There is no lock-wait time to record: the callback takes no locks, since
+// sound plays arrive through an SPSC queue and gains and the music loop are
+// atomics. Underruns can't be read from SDL's queued size either, which
+// only counts audio pushed with SDL_QueueAudio and is always 0 for a
+// callback device, so they are inferred from late callbacks instead.
+class AudioStats {
+public:
+    // Quarter-octave buckets of callback duration, from 1 us to about 65 ms
+    static constexpr int BUCKETS = 64;
+
+    struct Snapshot {
+        uint64_t callbacks = 0;
+        uint64_t deadlineMisses = 0;    // Took longer than the audio they produced
+        uint64_t underruns = 0;         // Started so late the device likely ran dry
+        double maxMs = 0.0;
+        std::array<uint64_t, BUCKETS> histogram{};
+
+        // Upper edge of the bucket holding quantile p of callback durations
+        double percentileMs(double p) const;
+    };
+
+    void setEnabled(bool enabled);
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Audio thread only. One callback that started at startNs, ran for
+    // durationNs and produced frames sample frames at sampleRate.
+    void record(uint64_t startNs, uint64_t durationNs, int frames, int sampleRate);
+
+    Snapshot snapshot() const;
+
+    // Monotonic clock for record()
+    static uint64_t nowNs();
+
+private:
+    static int bucketFor(uint64_t durationNs);
+    static double bucketUpperMs(int bucket);
+
+    // Only the audio thread writes these, so a load and store is enough
+    static void increment(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> enabled_{false};
+
+    std::atomic<uint64_t> callbacks_{0};
+    std::atomic<uint64_t> deadlineMisses_{0};
+    std::atomic<uint64_t> underruns_{0};
+    std::atomic<uint64_t> maxNs_{0};
+    std::array<std::atomic<uint64_t>, BUCKETS> histogram_{};
+
+    // Start of the previous callback, audio thread only; 0 after enabling
+    std::atomic<uint64_t> lastStartNs_{0};
+};
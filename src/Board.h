@@ -1,15 +1,64 @@
 #pragma once
 
 #include "Tetromino.h"
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <optional>
+#include <type_traits>
+#include <utility>
+
+// Playfield size used by the game, overridable from CMake
+#ifndef TETRIS_BOARD_WIDTH
+#define TETRIS_BOARD_WIDTH 10
+#endif
+#ifndef TETRIS_BOARD_HEIGHT
+#define TETRIS_BOARD_HEIGHT 20
+#endif
+
+namespace board_detail {
+
+// Smallest unsigned word that holds one bit per column
+template <int Width>
+using RowWord = std::conditional_t<(Width <= 16), uint16_t,
+                std::conditional_t<(Width <= 32), uint32_t, uint64_t>>;
+
+// Expands each bit of a 4-bit mask into a full nibble: 0b0101 -> 0x0F0F
+constexpr uint16_t expandToNibbles(unsigned bits) {
+    uint16_t result = 0;
+    for (int i = 0; i < 4; i++) {
+        if (bits & (1u << i)) result |= 0xF << (i * 4);
+    }
+    return result;
+}
+
+inline constexpr std::array<uint16_t, 16> NIBBLE_EXPAND = {
+    expandToNibbles(0),  expandToNibbles(1),  expandToNibbles(2),  expandToNibbles(3),
+    expandToNibbles(4),  expandToNibbles(5),  expandToNibbles(6),  expandToNibbles(7),
+    expandToNibbles(8),  expandToNibbles(9),  expandToNibbles(10), expandToNibbles(11),
+    expandToNibbles(12), expandToNibbles(13), expandToNibbles(14), expandToNibbles(15),
+};
+
+} // namespace board_detail
+
+// Bitboard playfield: one occupancy word per row plus a nibble-packed
+// color plane. Boards up to 64 columns keep a whole row in one word, so
+// collision and line detection are word-wide operations at any size.
+template <int Width, int Height>
+class BasicBoard {
+    static_assert(Width >= Tetromino::SIZE && Width <= 64, "Board width must be 4..64 columns");
+    static_assert(Height >= Tetromino::SIZE, "Board height must be at least 4 rows");
 
-class Board {
 public:
-    static constexpr int WIDTH = 10;
-    static constexpr int HEIGHT = 20;
+    static constexpr int WIDTH = Width;
+    static constexpr int HEIGHT = Height;
+
+    // One occupancy bit per cell, bit x is column x
+    using RowMask = board_detail::RowWord<Width>;
+    static constexpr RowMask FULL_ROW =
+        Width == 64 ? ~RowMask(0) : static_cast<RowMask>((uint64_t(1) << Width) - 1);
 
-    Board();
+    BasicBoard() { clear(); }
 
     bool isValidPosition(const Tetromino& piece) const;
     void placePiece(const Tetromino& piece);
@@ -17,11 +66,209 @@ public:
 
     std::optional<TetrominoType> getCell(int x, int y) const;
     bool isEmpty(int x, int y) const;
+    RowMask getRow(int y) const { return rows_[y]; }
 
     void clear();
 
+    // Rows changed since the last clearDirtyRows(), as [dirtyTop, dirtyBottom),
+    // so a renderer can repaint only what moved. A new board is all dirty.
+    int dirtyTop() const { return dirtyTop_; }
+    int dirtyBottom() const { return dirtyBottom_; }
+    bool hasDirtyRows() const { return dirtyTop_ < dirtyBottom_; }
+    void clearDirtyRows() {
+        dirtyTop_ = Height;
+        dirtyBottom_ = 0;
+    }
+
 private:
-    // Store the type of tetromino in each cell (for coloring)
-    // nullopt means empty
-    std::array<std::array<std::optional<TetrominoType>, WIDTH>, HEIGHT> grid_;
+    // Small boards scan every row with a fully unrolled compare; tall boards
+    // only rescan the rows touched by placements since the last clear
+    static constexpr bool UNROLLED = Height <= 64;
+
+    // 16 nibble-packed cells per color word
+    static constexpr int COLOR_WORDS = (Width + 15) / 16;
+
+    template <size_t... Ys>
+    uint64_t fullRowBits(std::index_sequence<Ys...>) const {
+        return ((static_cast<uint64_t>(rows_[Ys] == FULL_ROW) << Ys) | ...);
+    }
+
+    void writeColors(int boardY, int x, unsigned bits, TetrominoType type);
+
+    void markDirty(int top, int bottom) {
+        dirtyTop_ = std::min(dirtyTop_, top);
+        dirtyBottom_ = std::max(dirtyBottom_, bottom);
+    }
+
+    // Occupancy bitmask per row, used for collision and line detection
+    std::array<RowMask, Height> rows_;
+
+    // Tetromino type of each cell packed as 4-bit nibbles (nibble x is column x),
+    // only meaningful where the matching occupancy bit is set
+    std::array<std::array<uint64_t, COLOR_WORDS>, Height> colors_;
+
+    // Highest row holding any cell (Height when empty); rows above it never move
+    int stackTop_ = Height;
+
+    // Rows touched by placePiece since the last clearLines (tall boards only)
+    int pendingTop_ = Height;
+    int pendingBottom_ = -1;
+
+    int dirtyTop_ = 0;
+    int dirtyBottom_ = Height;
 };
+
+using Board = BasicBoard<TETRIS_BOARD_WIDTH, TETRIS_BOARD_HEIGHT>;
+
+// The game's board is instantiated once in Board.cpp
+extern template class BasicBoard<TETRIS_BOARD_WIDTH, TETRIS_BOARD_HEIGHT>;
+
+template <int Width, int Height>
+void BasicBoard<Width, Height>::clear() {
+    rows_.fill(0);
+    for (auto& row : colors_) {
+        row.fill(0);
+    }
+    stackTop_ = Height;
+    pendingTop_ = Height;
+    pendingBottom_ = -1;
+    markDirty(0, Height);
+}
+
+template <int Width, int Height>
+bool BasicBoard<Width, Height>::isValidPosition(const Tetromino& piece) const {
+    const ShapeInfo& shape = piece.getShape();
+    int pieceX = piece.getX();
+    int pieceY = piece.getY();
+
+    // Check bounds using the precomputed bounding box.
+    // Pieces above the board (negative Y) are allowed.
+    if (pieceX + shape.minX < 0 || pieceX + shape.maxX >= Width) return false;
+    if (pieceY + shape.maxY >= Height) return false;
+
+    // Check collision with placed pieces, one row mask at a time
+    for (int y = shape.minY; y <= shape.maxY; y++) {
+        int boardY = pieceY + y;
+        if (boardY < 0) continue;
+
+        RowMask bits = Tetromino::rowBits(shape.mask, y);
+        RowMask mask = pieceX < 0 ? bits >> -pieceX : bits << pieceX;
+        if (rows_[boardY] & mask) return false;
+    }
+    return true;
+}
+
+template <int Width, int Height>
+void BasicBoard<Width, Height>::placePiece(const Tetromino& piece) {
+    const ShapeInfo& shape = piece.getShape();
+    int pieceX = piece.getX();
+    int pieceY = piece.getY();
+
+    // Pieces are only placed at valid positions, the clip just keeps
+    // stray calls from writing outside the board
+    if (pieceX <= -Tetromino::SIZE || pieceX >= Width) return;
+
+    for (int y = shape.minY; y <= shape.maxY; y++) {
+        int boardY = pieceY + y;
+        if (boardY < 0 || boardY >= Height) continue;
+
+        RowMask bits = Tetromino::rowBits(shape.mask, y);
+        RowMask mask = pieceX < 0 ? bits >> -pieceX : (bits << pieceX) & FULL_ROW;
+        if (mask == 0) continue;
+
+        int x = std::max(pieceX, 0);
+        rows_[boardY] |= mask;
+        writeColors(boardY, x, static_cast<unsigned>(mask >> x), piece.getType());
+
+        stackTop_ = std::min(stackTop_, boardY);
+        markDirty(boardY, boardY + 1);
+        if constexpr (!UNROLLED) {
+            pendingTop_ = std::min(pendingTop_, boardY);
+            pendingBottom_ = std::max(pendingBottom_, boardY);
+        }
+    }
+}
+
+template <int Width, int Height>
+void BasicBoard<Width, Height>::writeColors(int boardY, int x, unsigned bits, TetrominoType type) {
+    // Type replicated into every nibble, masked down to the placed cells
+    uint64_t typeNibbles = static_cast<uint64_t>(type) * 0x1111111111111111ull;
+    uint64_t cellNibbles = board_detail::NIBBLE_EXPAND[bits];
+
+    auto& row = colors_[boardY];
+    int word = x / 16;
+    int shift = (x % 16) * 4;
+
+    uint64_t low = cellNibbles << shift;
+    row[word] = (row[word] & ~low) | (typeNibbles & low);
+
+    // The 4 cells can straddle two color words on wide boards
+    if (shift > 48 && word + 1 < COLOR_WORDS) {
+        uint64_t high = cellNibbles >> (64 - shift);
+        row[word + 1] = (row[word + 1] & ~high) | (typeNibbles & high);
+    }
+}
+
+template <int Width, int Height>
+int BasicBoard<Width, Height>::clearLines() {
+    // Find the lowest full row; nothing below it moves
+    int bottom = -1;
+    if constexpr (UNROLLED) {
+        uint64_t full = fullRowBits(std::make_index_sequence<Height>());
+        if (full == 0) return 0;
+        bottom = Height - 1;
+        while (!((full >> bottom) & 1)) bottom--;
+    } else {
+        for (int y = pendingBottom_; y >= pendingTop_; y--) {
+            if (rows_[y] == FULL_ROW) {
+                bottom = y;
+                break;
+            }
+        }
+        pendingTop_ = Height;
+        pendingBottom_ = -1;
+        if (bottom < 0) return 0;
+    }
+
+    // Every row from the top of the stack down to the lowest full row moves
+    markDirty(stackTop_, bottom + 1);
+
+    // Compact non-full rows towards the bottom in a single pass,
+    // stopping at the top of the stack since everything above is empty
+    int writeY = bottom;
+    for (int y = bottom; y >= stackTop_; y--) {
+        if (rows_[y] == FULL_ROW) continue;
+        if (writeY != y) {
+            rows_[writeY] = rows_[y];
+            colors_[writeY] = colors_[y];
+        }
+        writeY--;
+    }
+
+    int linesCleared = writeY - stackTop_ + 1;
+
+    // Clear the rows freed at the top
+    for (; writeY >= stackTop_; writeY--) {
+        rows_[writeY] = 0;
+        colors_[writeY].fill(0);
+    }
+    stackTop_ += linesCleared;
+
+    return linesCleared;
+}
+
+template <int Width, int Height>
+std::optional<TetrominoType> BasicBoard<Width, Height>::getCell(int x, int y) const {
+    if (isEmpty(x, y)) {
+        return std::nullopt;
+    }
+    return static_cast<TetrominoType>((colors_[y][x / 16] >> ((x % 16) * 4)) & 0xF);
+}
+
+template <int Width, int Height>
+bool BasicBoard<Width, Height>::isEmpty(int x, int y) const {
+    if (x < 0 || x >= Width || y < 0 || y >= Height) {
+        return true;
+    }
+    return !((rows_[y] >> x) & 1);
+}
@@ -0,0 +1,143 @@
+#include "Bot.h"
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+struct BoardFeatures {
+    int aggregateHeight = 0;
+    int holes = 0;
+    int bumpiness = 0;
+};
+
+BoardFeatures measure(const Board& board) {
+    BoardFeatures features;
+    std::array<int, Board::WIDTH> heights{};
+
+    // Walk down from the top: the first time a column is seen sets its
+    // height, and every empty cell under a seen column is a hole
+    Board::RowMask seen = 0;
+    for (int y = 0; y < Board::HEIGHT; y++) {
+        Board::RowMask row = board.getRow(y);
+        features.holes += static_cast<int>(std::bitset<64>(seen & ~row & Board::FULL_ROW).count());
+
+        Board::RowMask fresh = row & ~seen;
+        for (int x = 0; fresh != 0; x++, fresh >>= 1) {
+            if (fresh & 1) heights[x] = Board::HEIGHT - y;
+        }
+        seen |= row;
+    }
+
+    for (int x = 0; x < Board::WIDTH; x++) {
+        features.aggregateHeight += heights[x];
+        if (x > 0) features.bumpiness += std::abs(heights[x] - heights[x - 1]);
+    }
+    return features;
+}
+
+bool canSpawn(const Board& board, TetrominoType type) {
+    Tetromino piece(type);
+    piece.setPosition(Board::WIDTH / 2 - 2, 0);
+    return board.isValidPosition(piece);
+}
+
+constexpr double LOST = -std::numeric_limits<double>::infinity();
+
+} // namespace
+
+Bot::Bot(ThreadPool* pool)
+    : pool_(pool), generators_(pool ? pool->size() : 1) {}
+
+void Bot::setPool(ThreadPool* pool) {
+    pool_ = pool;
+    generators_.resize(pool ? pool->size() : 1);
+}
+
+void Bot::setPiecesPerSecond(double piecesPerSecond) {
+    minIntervalMs_ = piecesPerSecond > 0.0 ? static_cast<uint64_t>(1000.0 / piecesPerSecond) : 0;
+}
+
+uint32_t Bot::update(Simulation& simulation) {
+    if (simulation.isGameOver()) return 0;
+
+    uint64_t now = simulation.elapsedMs();
+    // The clock restarts with every new game
+    if (hasMoved_ && now < lastMoveMs_) {
+        hasMoved_ = false;
+    }
+    if (hasMoved_ && now - lastMoveMs_ < minIntervalMs_) {
+        return 0;
+    }
+
+    uint32_t events = 0;
+    for (Input input : plan(simulation)) {
+        events |= simulation.step(input, 0);
+    }
+
+    lastMoveMs_ = now;
+    hasMoved_ = true;
+    return events;
+}
+
+double Bot::evaluate(const Board& board, int linesCleared) const {
+    BoardFeatures features = measure(board);
+    return weights_.aggregateHeight * features.aggregateHeight
+         + weights_.linesCleared * linesCleared
+         + weights_.holes * features.holes
+         + weights_.bumpiness * features.bumpiness;
+}
+
+std::vector<Input> Bot::plan(const Simulation& simulation) {
+    const Board& board = simulation.board();
+    TetrominoType nextType = simulation.nextPiece().getType();
+
+    const std::vector<Placement>& candidates = rootGenerator_.generate(board, simulation.currentPiece());
+    if (candidates.empty()) return {};
+
+    scores_.assign(candidates.size(), LOST);
+
+    auto scoreCandidate = [&](size_t index, unsigned slot) {
+        Board afterFirst = board;
+        afterFirst.placePiece(candidates[index].piece);
+        int firstLines = afterFirst.clearLines();
+
+        if (!canSpawn(afterFirst, nextType)) return;
+
+        Tetromino next(nextType);
+        next.setPosition(Board::WIDTH / 2 - 2, 0);
+
+        const std::vector<Placement>& replies = generators_[slot].generate(afterFirst, next);
+        if (replies.empty()) {
+            scores_[index] = evaluate(afterFirst, firstLines);
+            return;
+        }
+
+        double best = LOST;
+        for (const Placement& reply : replies) {
+            Board afterSecond = afterFirst;
+            afterSecond.placePiece(reply.piece);
+            int secondLines = afterSecond.clearLines();
+            best = std::max(best, evaluate(afterSecond, firstLines + secondLines));
+        }
+        scores_[index] = best;
+    };
+
+    if (pool_) {
+        pool_->parallelFor(candidates.size(), scoreCandidate);
+    } else {
+        for (size_t i = 0; i < candidates.size(); i++) {
+            scoreCandidate(i, 0);
+        }
+    }
+
+    // Ties go to the earliest candidate so results don't depend on threading
+    size_t bestIndex = 0;
+    for (size_t i = 1; i < candidates.size(); i++) {
+        if (scores_[i] > scores_[bestIndex]) bestIndex = i;
+    }
+
+    return rootGenerator_.pathTo(candidates[bestIndex]);
+}
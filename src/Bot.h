@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Board.h"
+#include "MoveGenerator.h"
+#include "Simulation.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <vector>
+
+// Weights of the board features the bot scores placements with
+struct BotWeights {
+    double aggregateHeight = -0.510066;
+    double linesCleared = 0.760666;
+    double holes = -0.35663;
+    double bumpiness = -0.184483;
+};
+
+// Heuristic player. Every reachable placement of the current piece is
+// combined with every placement of the next piece and the best pair is
+// played. Moves go through Simulation::step, i.e. the same tryMove /
+// tryRotate / hardDrop code a human player triggers.
+class Bot {
+public:
+    // Candidates are scored across pool if given, otherwise on the caller
+    explicit Bot(ThreadPool* pool = nullptr);
+
+    // Switches to scoring across pool, or on the caller if null
+    void setPool(ThreadPool* pool);
+
+    void setWeights(const BotWeights& weights) { weights_ = weights; }
+
+    // Caps play speed by simulation time; 0 removes the cap
+    void setPiecesPerSecond(double piecesPerSecond);
+
+    // Plays one piece if the cap allows it. Returns the GameEvent bits of
+    // the inputs sent, or 0 if the bot is waiting or the game is over.
+    uint32_t update(Simulation& simulation);
+
+    // Simulation time at which the cap next lets the bot play
+    uint64_t nextMoveMs() const { return hasMoved_ ? lastMoveMs_ + minIntervalMs_ : 0; }
+
+    // Inputs for the best placement of the current piece, ending in a hard
+    // drop; empty if the piece has nowhere to go
+    std::vector<Input> plan(const Simulation& simulation);
+
+    double evaluate(const Board& board, int linesCleared) const;
+
+private:
+    ThreadPool* pool_;
+    BotWeights weights_;
+
+    uint64_t minIntervalMs_ = 0;
+    uint64_t lastMoveMs_ = 0;
+    bool hasMoved_ = false;
+
+    // One generator per pool slot for the lookahead, plus one for the first ply
+    MoveGenerator rootGenerator_;
+    std::vector<MoveGenerator> generators_;
+    std::vector<double> scores_;
+};
@@ -0,0 +1,70 @@
+#include "FrameStats.h"
+#include <algorithm>
+
+void FrameStats::Ring::push(double value) {
+    samples[next] = value;
+    next = (next + 1) % WINDOW;
+    size = std::min(size + 1, WINDOW);
+}
+
+bool FrameStats::openCsv(const std::string& path) {
+    csv_.open(path, std::ios::trunc);
+    if (!csv_) {
+        return false;
+    }
+
+    csv_ << "frame,frame_ms,update_ms,render_ms,present_ms,input_latency_ms\n";
+    return true;
+}
+
+void FrameStats::addFrame(const FrameTimes& times) {
+    rings_[static_cast<size_t>(FrameMetric::Frame)].push(times.frame);
+    rings_[static_cast<size_t>(FrameMetric::Update)].push(times.update);
+    rings_[static_cast<size_t>(FrameMetric::Render)].push(times.render);
+    rings_[static_cast<size_t>(FrameMetric::Present)].push(times.present);
+    if (times.inputLatency >= 0.0) {
+        rings_[static_cast<size_t>(FrameMetric::InputLatency)].push(times.inputLatency);
+    }
+
+    if (csv_.is_open()) {
+        csv_ << frameCount_ << ',' << times.frame << ',' << times.update << ','
+             << times.render << ',' << times.present << ',';
+        if (times.inputLatency >= 0.0) {
+            csv_ << times.inputLatency;
+        }
+        csv_ << '\n';
+    }
+
+    frameCount_++;
+}
+
+FrameStats::Summary FrameStats::summary(FrameMetric metric) const {
+    const Ring& ring = rings_[static_cast<size_t>(metric)];
+
+    Summary result;
+    result.samples = ring.size;
+    if (ring.size == 0) {
+        return result;
+    }
+
+    sorted_.assign(ring.samples.begin(), ring.samples.begin() + ring.size);
+    std::sort(sorted_.begin(), sorted_.end());
+
+    auto at = [&](double p) { return sorted_[static_cast<size_t>(p * (sorted_.size() - 1) + 0.5)]; };
+    result.p50 = at(0.50);
+    result.p99 = at(0.99);
+    result.max = sorted_.back();
+    return result;
+}
+
+const char* FrameStats::metricName(FrameMetric metric) {
+    switch (metric) {
+        case FrameMetric::Frame: return "FRAME";
+        case FrameMetric::Update: return "UPDATE";
+        case FrameMetric::Render: return "RENDER";
+        case FrameMetric::Present: return "PRESENT";
+        case FrameMetric::InputLatency: return "INPUT";
+        case FrameMetric::Count: break;
+    }
+    return "";
+}
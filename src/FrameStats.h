@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+enum class FrameMetric : uint8_t {
+    Frame,          // Start of one frame to the start of the next
+    Update,         // Input polling and simulation
+    Render,         // Issuing draw calls
+    Present,        // SDL_RenderPresent, including any vsync wait
+    InputLatency,   // Key event timestamp to the present that showed it
+    Count
+};
+
+// Timings of one frame in milliseconds. inputLatency is negative when no
+// input arrived during the frame.
+struct FrameTimes {
+    double frame = 0.0;
+    double update = 0.0;
+    double render = 0.0;
+    double present = 0.0;
+    double inputLatency = -1.0;
+};
+
+// Rolling window of recent frame timings for the performance HUD, with an
+// optional CSV log of every frame for offline analysis
+class FrameStats {
+public:
+    struct Summary {
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+        size_t samples = 0;
+    };
+
+    static constexpr size_t WINDOW = 240; // About one to four seconds of frames
+
+    // Starts logging each frame to path, replacing the file
+    bool openCsv(const std::string& path);
+
+    void addFrame(const FrameTimes& times);
+
+    Summary summary(FrameMetric metric) const;
+
+    static const char* metricName(FrameMetric metric);
+
+private:
+    static constexpr size_t METRIC_COUNT = static_cast<size_t>(FrameMetric::Count);
+
+    struct Ring {
+        std::array<double, WINDOW> samples{};
+        size_t next = 0;
+        size_t size = 0;
+
+        void push(double value);
+    };
+
+    std::array<Ring, METRIC_COUNT> rings_;
+    uint64_t frameCount_ = 0;
+
+    std::ofstream csv_;
+
+    // Scratch for percentile selection, kept to avoid allocating per call
+    mutable std::vector<double> sorted_;
+};
@@ -1,22 +1,36 @@
 #include "Game.h"
-#include <chrono>
-
-Game::Game() : rng_(std::random_device{}()) {}
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <tuple>
+#include <utility>
+
+Game::Game(uint32_t seed)
+    : simulation_(seed),
+      counterFrequency_(SDL_GetPerformanceFrequency()),
+      ticksPerStep_(std::max<Uint64>(1, counterFrequency_ * TICK_MS / 1000)) {
+    bot_.setPiecesPerSecond(DEFAULT_BOT_PPS);
+}
 
 bool Game::init() {
-    if (!renderer_.init()) {
+    if (!renderer_.init(vsync_)) {
         return false;
     }
 
-    sound_.init(); // Audio is optional, continue even if it fails
-    music_.init();
-    music_.play();
+    audio_.init(); // Audio is optional, continue even if it fails
+    if (!musicCachePath_.empty()) {
+        audio_.startMusicCache(musicCachePath_);
+    }
+    updateAudioStats();
+    audio_.music().play();
 
-    spawnNewPiece();
-    spawnNewPiece(); // First call sets next, second sets current and new next
+    if (!replayPrefix_.empty()) {
+        replay_ = Replay(simulation_.seed());
+        simulation_.setRecorder(&replay_);
+    }
 
-    lastDropTime_ = SDL_GetTicks();
-    gameStartTime_ = SDL_GetTicks();
+    lastCounter_ = SDL_GetPerformanceCounter();
+    accumulator_ = 0;
     running_ = true;
 
     return true;
@@ -24,224 +38,343 @@ bool Game::init() {
 
 void Game::run() {
     while (running_) {
-        handleInput();
+        Uint64 frameStart = SDL_GetPerformanceCounter();
 
-        if (!gameOver_) {
-            update();
+        handleInput();
+        update();
+
+        if (!needsRedraw()) {
+            // Input that changed nothing never reaches the screen
+            hasPendingInput_ = false;
+            frameTimes_ = FrameTimes();
+            waitForChange();
+            continue;
         }
+        frameTimes_.update = countsToMs(SDL_GetPerformanceCounter() - frameStart);
 
         render();
 
-        SDL_Delay(16); // ~60 FPS
+        waitForNextFrame(frameStart);
+
+        frameTimes_.frame = countsToMs(SDL_GetPerformanceCounter() - frameStart);
+        frameStats_.addFrame(frameTimes_);
+        frameTimes_ = FrameTimes();
+    }
+}
+
+double Game::countsToMs(Uint64 counts) const {
+    return static_cast<double>(counts) * 1000.0 / counterFrequency_;
+}
+
+void Game::waitForNextFrame(Uint64 frameStart) {
+    if (maxFps_ <= 0.0) {
+        return;
+    }
+
+    Uint64 frameTicks = static_cast<Uint64>(counterFrequency_ / maxFps_);
+    Uint64 deadline = frameStart + frameTicks;
+
+    // With vsync granted, present() already waits for the refresh, so an
+    // oversleep is absorbed there and a plain sleep is enough
+    if (renderer_.hasVsync()) {
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now < deadline) {
+            SDL_Delay(static_cast<Uint32>((deadline - now) * 1000 / counterFrequency_));
+        }
+        return;
     }
+
+    // SDL_Delay can oversleep by a millisecond or more, so sleep until just
+    // before the deadline and spin for the rest
+    for (;;) {
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now >= deadline) break;
+
+        Uint64 remainingMs = (deadline - now) * 1000 / counterFrequency_;
+        if (remainingMs > 1) {
+            SDL_Delay(static_cast<Uint32>(remainingMs - 1));
+        }
+    }
+}
+
+void Game::updateAudioStats() {
+    audio_.stats().setEnabled(perfHud_ || perfLog_);
 }
 
 void Game::shutdown() {
-    music_.shutdown();
-    sound_.shutdown();
+    if (perfLog_) {
+        AudioStats::Snapshot audio = audio_.stats().snapshot();
+        std::cerr << "Audio callbacks: " << audio.callbacks
+                  << ", p50 " << audio.percentileMs(0.50) << " ms"
+                  << ", p99 " << audio.percentileMs(0.99) << " ms"
+                  << ", max " << audio.maxMs << " ms"
+                  << ", deadline misses " << audio.deadlineMisses
+                  << ", underruns " << audio.underruns << std::endl;
+    }
+
+    // A game still in progress is saved as it stands
+    if (!replayPrefix_.empty() && !simulation_.isGameOver()) {
+        saveReplay();
+    }
+    simulation_.setRecorder(nullptr);
+
+    audio_.shutdown();
     renderer_.shutdown();
 }
 
+void Game::setFramePacing(bool vsync, double maxFps) {
+    vsync_ = vsync;
+    maxFps_ = maxFps;
+}
+
+void Game::setBot(bool enabled, double piecesPerSecond) {
+    setBotEnabled(enabled);
+    bot_.setPiecesPerSecond(piecesPerSecond);
+}
+
+void Game::setBotEnabled(bool enabled) {
+    if (enabled && !botPool_) {
+        botPool_ = std::make_unique<ThreadPool>();
+        bot_.setPool(botPool_.get());
+    }
+    botEnabled_ = enabled;
+}
+
 void Game::handleInput() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
+        renderer_.handleEvent(event);
+
+        if (event.type == SDL_WINDOWEVENT || event.type == SDL_RENDER_TARGETS_RESET ||
+            event.type == SDL_RENDER_DEVICE_RESET) {
+            redrawNeeded_ = true;
+        }
+
         if (event.type == SDL_QUIT) {
             running_ = false;
         }
 
         if (event.type == SDL_KEYDOWN) {
-            if (gameOver_) {
+            if (!hasPendingInput_) {
+                pendingInputTime_ = event.key.timestamp;
+                hasPendingInput_ = true;
+            }
+
+            if (event.key.keysym.sym == SDLK_F3) {
+                perfHud_ = !perfHud_;
+                updateAudioStats();
+                redrawNeeded_ = true;
+                continue;
+            }
+
+            Input input = Input::None;
+
+            if (simulation_.isGameOver()) {
                 // Press any key to restart
                 if (event.key.keysym.sym == SDLK_RETURN || event.key.keysym.sym == SDLK_SPACE) {
-                    board_.clear();
-                    score_ = 0;
-                    level_ = 1;
-                    totalLines_ = 0;
-                    dropInterval_ = 500;
-                    gameOver_ = false;
-                    gameStartTime_ = SDL_GetTicks();
-                    currentPiece_.reset();
-                    nextPiece_.reset();
-                    spawnNewPiece();
-                    spawnNewPiece();
-                    music_.play();
+                    input = Input::Restart;
+                }
+            } else {
+                switch (event.key.keysym.sym) {
+                    case SDLK_LEFT:
+                        input = Input::Left;
+                        break;
+                    case SDLK_RIGHT:
+                        input = Input::Right;
+                        break;
+                    case SDLK_DOWN:
+                        input = Input::SoftDrop;
+                        break;
+                    case SDLK_UP:
+                        input = Input::Rotate;
+                        break;
+                    case SDLK_SPACE:
+                        input = Input::HardDrop;
+                        break;
+                    case SDLK_ESCAPE:
+                        running_ = false;
+                        break;
+                    case SDLK_b:
+                        setBotEnabled(!botEnabled_);
+                        break;
                 }
-                continue;
             }
 
-            switch (event.key.keysym.sym) {
-                case SDLK_LEFT:
-                    if (tryMove(-1, 0)) {
-                        sound_.play(SoundEffect::Move);
-                    }
-                    break;
-                case SDLK_RIGHT:
-                    if (tryMove(1, 0)) {
-                        sound_.play(SoundEffect::Move);
-                    }
-                    break;
-                case SDLK_DOWN:
-                    if (tryMove(0, 1)) {
-                        score_ += 1; // Soft drop bonus
-                        sound_.play(SoundEffect::Move);
-                    }
-                    break;
-                case SDLK_UP:
-                    if (tryRotate()) {
-                        sound_.play(SoundEffect::Rotate);
-                    }
-                    break;
-                case SDLK_SPACE:
-                    hardDrop();
-                    break;
-                case SDLK_ESCAPE:
-                    running_ = false;
-                    break;
+            if (input != Input::None) {
+                handleEvents(simulation_.step(input, 0));
             }
         }
     }
 }
 
 void Game::update() {
-    Uint32 currentTime = SDL_GetTicks();
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 maxAccumulated = counterFrequency_ * MAX_CATCH_UP_MS / 1000;
+    accumulator_ = std::min(accumulator_ + (now - lastCounter_), maxAccumulated);
+    lastCounter_ = now;
+
+    // The bot plans once per frame, like a player reacting to what is shown
+    uint32_t events = 0;
+    if (botEnabled_) {
+        events |= bot_.update(simulation_);
+    }
 
-    if (currentTime - lastDropTime_ >= dropInterval_) {
-        if (!tryMove(0, 1)) {
-            lockPiece();
-        }
-        lastDropTime_ = currentTime;
+    while (accumulator_ >= ticksPerStep_) {
+        accumulator_ -= ticksPerStep_;
+        events |= simulation_.step(Input::None, TICK_MS);
     }
-}
 
-void Game::render() {
-    renderer_.clear();
-    renderer_.drawBoard(board_);
+    handleEvents(events);
+}
 
-    if (currentPiece_) {
-        renderer_.drawPiece(*currentPiece_);
+void Game::handleEvents(uint32_t events) {
+    // Same order the rules raise them in, so the last sound wins as before
+    static const std::pair<GameEvent, SoundEffect> soundForEvent[] = {
+        {GameEvent::Move, SoundEffect::Move},
+        {GameEvent::Rotate, SoundEffect::Rotate},
+        {GameEvent::Drop, SoundEffect::Drop},
+        {GameEvent::LineClear, SoundEffect::LineClear},
+        {GameEvent::Tetris, SoundEffect::Tetris},
+        {GameEvent::LevelUp, SoundEffect::LevelUp},
+        {GameEvent::GameOver, SoundEffect::GameOver},
+    };
+
+    for (const auto& [event, effect] : soundForEvent) {
+        if (events & eventBit(event)) {
+            audio_.sound().play(effect);
+        }
     }
 
-    if (nextPiece_) {
-        renderer_.drawNextPiece(*nextPiece_);
+    if (events & eventBit(GameEvent::GameOver)) {
+        audio_.music().stop();
+        if (!replayPrefix_.empty()) {
+            saveReplay();
+        }
     }
-
-    // Calculate elapsed time in seconds
-    int elapsedSeconds = (SDL_GetTicks() - gameStartTime_) / 1000;
-    renderer_.drawStats(score_, level_, totalLines_, elapsedSeconds);
-
-    if (gameOver_) {
-        renderer_.drawGameOver();
+    if (events & eventBit(GameEvent::Restart)) {
+        audio_.music().play();
+        replay_ = Replay(simulation_.seed());
     }
-
-    renderer_.present();
 }
 
-void Game::spawnNewPiece() {
-    if (nextPiece_) {
-        currentPiece_ = std::move(nextPiece_);
+void Game::saveReplay() {
+    replay_.finish(simulation_);
+
+    std::string path = replayPrefix_ + "-" + std::to_string(replay_.seed()) + ".trp";
+    if (!replay_.save(path)) {
+        std::cerr << "Failed to save replay to " << path << std::endl;
     }
+}
 
-    // Generate random piece type
-    std::uniform_int_distribution<int> dist(0, static_cast<int>(TetrominoType::Count) - 1);
-    auto type = static_cast<TetrominoType>(dist(rng_));
+void Game::render() {
+    Uint64 renderStart = SDL_GetPerformanceCounter();
 
-    nextPiece_ = std::make_unique<Tetromino>(type);
+    FrameState state = frameState();
 
-    if (currentPiece_) {
-        // Position piece at top center of board
-        currentPiece_->setPosition(Board::WIDTH / 2 - 2, 0);
+    renderer_.clear();
+    renderer_.drawBoard(simulation_.board());
+    simulation_.clearDirtyRows();
+    renderer_.drawPiece(simulation_.currentPiece(), state.fallOffset);
+    renderer_.drawNextPiece(simulation_.nextPiece());
+    renderer_.drawStats(state.score, state.level, state.lines, state.seconds);
 
-        // Check if spawn position is valid (game over if not)
-        if (!board_.isValidPosition(*currentPiece_)) {
-            gameOver_ = true;
-            music_.stop();
-            sound_.play(SoundEffect::GameOver);
-        }
+    if (state.gameOver) {
+        renderer_.drawGameOver();
     }
-}
 
-void Game::lockPiece() {
-    if (!currentPiece_) return;
-
-    board_.placePiece(*currentPiece_);
+    if (perfHud_) {
+        renderer_.drawPerfHud(frameStats_, audio_.stats().snapshot());
+    }
 
-    int linesCleared = board_.clearLines();
-    if (linesCleared > 0) {
-        score_ += calculateScore(linesCleared);
-        totalLines_ += linesCleared;
+    Uint64 presentStart = SDL_GetPerformanceCounter();
+    renderer_.present();
+    Uint64 presentEnd = SDL_GetPerformanceCounter();
 
-        // Play appropriate sound for lines cleared
-        if (linesCleared == 4) {
-            sound_.play(SoundEffect::Tetris);
-        } else {
-            sound_.play(SoundEffect::LineClear);
-        }
+    frameTimes_.render = countsToMs(presentStart - renderStart);
+    frameTimes_.present = countsToMs(presentEnd - presentStart);
 
-        // Level up
-        int newLevel = totalLines_ / LINES_PER_LEVEL + 1;
-        if (newLevel > level_) {
-            level_ = newLevel;
-            dropInterval_ = std::max(MIN_DROP_INTERVAL, static_cast<Uint32>(500 - (level_ - 1) * 50));
-            sound_.play(SoundEffect::LevelUp);
-        }
+    // Event timestamps only have millisecond resolution
+    if (hasPendingInput_) {
+        frameTimes_.inputLatency = static_cast<double>(SDL_GetTicks() - pendingInputTime_);
+        hasPendingInput_ = false;
     }
 
-    spawnNewPiece();
+    drawnState_ = state;
+    redrawNeeded_ = false;
 }
 
-bool Game::tryMove(int dx, int dy) {
-    if (!currentPiece_) return false;
-
-    currentPiece_->move(dx, dy);
-
-    if (!board_.isValidPosition(*currentPiece_)) {
-        currentPiece_->move(-dx, -dy);
-        return false;
-    }
+bool Game::FrameState::operator==(const FrameState& other) const {
+    return std::tie(pieceType, pieceX, pieceY, pieceRotation, fallOffset, nextType,
+                    score, level, lines, seconds, gameOver) ==
+           std::tie(other.pieceType, other.pieceX, other.pieceY, other.pieceRotation, other.fallOffset,
+                    other.nextType, other.score, other.level, other.lines, other.seconds, other.gameOver);
+}
 
-    return true;
+Game::FrameState Game::frameState() const {
+    const Tetromino& piece = simulation_.currentPiece();
+
+    FrameState state;
+    state.pieceType = piece.getType();
+    state.pieceX = piece.getX();
+    state.pieceY = piece.getY();
+    state.pieceRotation = piece.getRotation();
+    state.fallOffset = fallOffset();
+    state.nextType = simulation_.nextPiece().getType();
+    state.score = simulation_.score();
+    state.level = simulation_.level();
+    state.lines = simulation_.totalLines();
+    state.seconds = static_cast<int>(simulation_.elapsedMs() / 1000);
+    state.gameOver = simulation_.isGameOver();
+    return state;
 }
 
-bool Game::tryRotate() {
-    if (!currentPiece_) return false;
+bool Game::needsRedraw() const {
+    return redrawNeeded_ || simulation_.board().hasDirtyRows() || !(frameState() == drawnState_);
+}
 
-    currentPiece_->rotateClockwise();
+void Game::waitForChange() {
+    double nowMs = displayTimeMs();
 
-    if (!board_.isValidPosition(*currentPiece_)) {
-        // Try wall kicks
-        static const int kicks[][2] = {{-1, 0}, {1, 0}, {-2, 0}, {2, 0}, {0, -1}};
+    // The clock keeps counting on the game over screen too
+    double deadlineMs = static_cast<double>((simulation_.elapsedMs() / 1000 + 1) * 1000);
+    if (!simulation_.isGameOver()) {
+        double dropMs = static_cast<double>(simulation_.nextDropMs());
+        deadlineMs = std::min(deadlineMs, dropMs);
 
-        for (const auto& kick : kicks) {
-            currentPiece_->move(kick[0], kick[1]);
-            if (board_.isValidPosition(*currentPiece_)) {
-                return true;
-            }
-            currentPiece_->move(-kick[0], -kick[1]);
+        // The interpolated piece moves down one pixel at a time
+        if (pieceCanFall()) {
+            double msPerPixel = static_cast<double>(simulation_.dropInterval()) / Renderer::CELL_SIZE;
+            deadlineMs = std::min(deadlineMs, dropMs - (Renderer::CELL_SIZE - drawnState_.fallOffset - 1) * msPerPixel);
+        }
+        if (botEnabled_) {
+            deadlineMs = std::min(deadlineMs, static_cast<double>(bot_.nextMoveMs()));
         }
-
-        // No valid position found, revert rotation
-        currentPiece_->rotateCounterClockwise();
-        return false;
     }
 
-    return true;
+    // Capped so the accumulator never drops time while idle
+    double waitMs = std::clamp(std::ceil(deadlineMs - nowMs), 1.0, static_cast<double>(MAX_IDLE_WAIT_MS));
+    SDL_WaitEventTimeout(nullptr, static_cast<int>(waitMs));
 }
 
-void Game::hardDrop() {
-    if (!currentPiece_) return;
+bool Game::pieceCanFall() const {
+    Tetromino below = simulation_.currentPiece();
+    below.move(0, 1);
+    return simulation_.board().isValidPosition(below);
+}
 
-    int dropDistance = 0;
-    while (tryMove(0, 1)) {
-        dropDistance++;
+double Game::displayTimeMs() const {
+    return static_cast<double>(simulation_.elapsedMs()) +
+           static_cast<double>(accumulator_) * 1000.0 / counterFrequency_;
+}
+
+int Game::fallOffset() const {
+    // Only slide toward a row the piece can actually fall into
+    if (simulation_.isGameOver() || !pieceCanFall()) {
+        return 0;
     }
 
-    score_ += dropDistance * 2; // Hard drop bonus
-    sound_.play(SoundEffect::Drop);
-    lockPiece();
-}
+    double untilDrop = static_cast<double>(simulation_.nextDropMs()) - displayTimeMs();
+    double progress = 1.0 - untilDrop / simulation_.dropInterval();
 
-int Game::calculateScore(int linesCleared) {
-    // Classic Tetris scoring
-    static const int scoreTable[] = {0, 100, 300, 500, 800};
-    return scoreTable[linesCleared] * level_;
+    return std::clamp(static_cast<int>(progress * Renderer::CELL_SIZE), 0, Renderer::CELL_SIZE - 1);
 }
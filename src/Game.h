@@ -1,55 +1,141 @@
 #pragma once
 
-#include "Board.h"
-#include "Tetromino.h"
+#include "AudioEngine.h"
+#include "Bot.h"
+#include "FrameStats.h"
+#include "Replay.h"
+#include "Simulation.h"
+#include "ThreadPool.h"
 #include "Renderer.h"
-#include "Sound.h"
-#include "Music.h"
 #include <memory>
-#include <random>
+#include <string>
 
+// SDL frontend: feeds keyboard input and wall-clock time into the
+// Simulation and presents its state with video and audio.
+//
+// The simulation advances in fixed TICK_MS steps from an accumulator of
+// high-resolution time, independent of the frame rate. Input is applied as
+// soon as it is polled and each frame interpolates the falling piece
+// between gravity drops, so rendering faster only makes motion smoother.
+//
+// Frames are only drawn when something visible changed. Otherwise the loop
+// sleeps in SDL_WaitEventTimeout until input arrives or the next moment the
+// picture could change, such as a gravity drop or the clock's next second.
 class Game {
 public:
-    Game();
+    explicit Game(uint32_t seed);
 
     bool init();
     void run();
     void shutdown();
 
+    // Let the built-in bot play; piecesPerSecond 0 plays as fast as frames allow
+    void setBot(bool enabled, double piecesPerSecond);
+
+    // Save a replay of every game to <prefix>-<seed>.trp when it ends or
+    // the window is closed. Call before init().
+    void setReplayPrefix(const std::string& prefix) { replayPrefix_ = prefix; }
+
+    // Frames wait for the display refresh when vsync is on, and are further
+    // limited to maxFps if that is above 0. Call before init().
+    void setFramePacing(bool vsync, double maxFps);
+
+    // Play the music from a pre-rendered loop cached at path, which is
+    // created on first use. Call before init().
+    void setMusicCache(const std::string& path) { musicCachePath_ = path; }
+
+    // Frame and audio timing overlay, also toggled with F3
+    void setPerfHud(bool visible) { perfHud_ = visible; }
+
+    // Logs every frame's timings to a CSV file, and an audio timing summary
+    // to stderr on shutdown
+    bool setPerfLog(const std::string& path) {
+        perfLog_ = frameStats_.openCsv(path);
+        return perfLog_;
+    }
+
+    // Draws and presents one frame of the current state
+    void render();
+
+    static constexpr double DEFAULT_BOT_PPS = 3.0;
+    static constexpr double DEFAULT_MAX_FPS = 240.0;
+
+    static constexpr uint32_t TICK_MS = 1;        // Matches the simulation's clock resolution
+    static constexpr uint32_t MAX_CATCH_UP_MS = 250; // Longer stalls are dropped, not replayed
+    static constexpr uint32_t MAX_IDLE_WAIT_MS = 100; // Well under MAX_CATCH_UP_MS
+
 private:
+    // Everything a frame shows, compared with the last drawn frame
+    struct FrameState {
+        TetrominoType pieceType = TetrominoType::Count;
+        int pieceX = 0;
+        int pieceY = 0;
+        int pieceRotation = 0;
+        int fallOffset = 0;
+        TetrominoType nextType = TetrominoType::Count;
+        int score = 0;
+        int level = 0;
+        int lines = 0;
+        int seconds = 0;
+        bool gameOver = false;
+
+        bool operator==(const FrameState& other) const;
+    };
+
     void handleInput();
+    void setBotEnabled(bool enabled);
     void update();
-    void render();
 
-    void spawnNewPiece();
-    void lockPiece();
-    bool tryMove(int dx, int dy);
-    bool tryRotate();
-    void hardDrop();
+    void handleEvents(uint32_t events);
+    void saveReplay();
+    void waitForNextFrame(Uint64 frameStart);
+    void updateAudioStats();
+
+    FrameState frameState() const;
+    bool needsRedraw() const;
+    // Sleeps until an event arrives or the drawn state could next change
+    void waitForChange();
 
-    int calculateScore(int linesCleared);
+    bool pieceCanFall() const;
+    int fallOffset() const;
+    // Simulated time plus the fraction of a tick still in the accumulator
+    double displayTimeMs() const;
+    double countsToMs(Uint64 counts) const;
 
-    Board board_;
+    Simulation simulation_;
     Renderer renderer_;
-    Sound sound_;
-    Music music_;
+    AudioEngine audio_;
+    std::string musicCachePath_;
 
-    std::unique_ptr<Tetromino> currentPiece_;
-    std::unique_ptr<Tetromino> nextPiece_;
+    // Created the first time the bot is enabled, so a human-only game
+    // starts no worker threads
+    std::unique_ptr<ThreadPool> botPool_;
+    Bot bot_;
+    bool botEnabled_ = false;
 
-    std::mt19937 rng_;
+    Replay replay_;
+    std::string replayPrefix_;
 
     bool running_ = false;
-    bool gameOver_ = false;
 
-    int score_ = 0;
-    int level_ = 1;
-    int totalLines_ = 0;
+    bool vsync_ = true;
+    double maxFps_ = DEFAULT_MAX_FPS;
+
+    // Performance counter ticks; accumulator_ holds time not yet simulated
+    Uint64 counterFrequency_;
+    Uint64 ticksPerStep_;
+    Uint64 lastCounter_ = 0;
+    Uint64 accumulator_ = 0;
+
+    FrameStats frameStats_;
+    FrameTimes frameTimes_;     // Filled in over the current frame
+    bool perfHud_ = false;
+    bool perfLog_ = false;
 
-    Uint32 lastDropTime_ = 0;
-    Uint32 dropInterval_ = 500; // milliseconds
-    Uint32 gameStartTime_ = 0;
+    FrameState drawnState_;
+    bool redrawNeeded_ = true;  // Window exposed, resized or HUD toggled
 
-    static constexpr int LINES_PER_LEVEL = 10;
-    static constexpr Uint32 MIN_DROP_INTERVAL = 50;
+    // SDL timestamp of the first key press not yet shown on screen
+    Uint32 pendingInputTime_ = 0;
+    bool hasPendingInput_ = false;
 };
@@ -0,0 +1,77 @@
+#include "Mixer.h"
+#include <algorithm>
+
+namespace {
+
+// Rational tanh approximation: unity gain near zero, easing into +-1 at +-3
+float softClip(float x) {
+    x = std::clamp(x, -3.0f, 3.0f);
+    float x2 = x * x;
+    return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+}
+
+} // namespace
+
+Mixer::Mixer(Music& music, Sound& sound) : music_(music), sound_(sound) {
+    for (std::atomic<float>& gain : gains_) {
+        gain.store(1.0f, std::memory_order_relaxed);
+    }
+}
+
+void Mixer::setGain(AudioBus bus, float gain) {
+    gains_[static_cast<size_t>(bus)].store(std::max(0.0f, gain), std::memory_order_relaxed);
+}
+
+float Mixer::gain(AudioBus bus) const {
+    return gains_[static_cast<size_t>(bus)].load(std::memory_order_relaxed);
+}
+
+void Mixer::setSampleRate(int sampleRate) {
+    int sourceRate = sampleRate;
+    if (sampleRate < MIN_NATIVE_RATE || sampleRate > MAX_NATIVE_RATE) {
+        sourceRate = Music::DEFAULT_SAMPLE_RATE;
+    }
+
+    // A ratio with too many phases is synthesised directly after all
+    resampling_ = sourceRate != sampleRate && resampler_.configure(sourceRate, sampleRate);
+    if (!resampling_) {
+        sourceRate = sampleRate;
+    }
+
+    sampleRate_ = sampleRate;
+    music_.setSampleRate(sourceRate);
+    sound_.setSampleRate(sourceRate);
+}
+
+void Mixer::render(float* out, int samples) {
+    if (resampling_) {
+        resampler_.render(out, samples, [this](float* in, int count) { renderSources(in, count); });
+    } else {
+        renderSources(out, samples);
+    }
+}
+
+void Mixer::renderSources(float* out, int samples) {
+    for (int done = 0; done < samples; done += BLOCK_SIZE) {
+        renderBlock(out + done, std::min(BLOCK_SIZE, samples - done));
+    }
+}
+
+void Mixer::renderBlock(float* out, int samples) {
+    // A stopped track holds its position, like a paused device did
+    float musicGain = gain(AudioBus::Music);
+    if (music_.isPlaying()) {
+        music_.render(musicBlock_.data(), samples);
+    } else {
+        musicGain = 0.0f;
+        std::fill(musicBlock_.begin(), musicBlock_.begin() + samples, 0.0f);
+    }
+
+    // Effects always run so voices finish and queued plays are taken
+    sound_.render(effectsBlock_.data(), samples);
+    float effectsGain = gain(AudioBus::Effects);
+
+    for (int i = 0; i < samples; i++) {
+        out[i] = softClip(musicBlock_[i] * musicGain + effectsBlock_[i] * effectsGain);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Music.h"
+#include "Resampler.h"
+#include "Sound.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum class AudioBus : uint8_t {
+    Music,
+    Effects,
+    Count
+};
+
+// The audio graph: the music and sound effect buses, each with its own
+// gain, summed and soft clipped into one mono stream. Sources render a
+// whole block at a time into scratch buffers, so every stage runs a tight
+// loop instead of a call per sample. The sources synthesise at the output
+// rate when they can; otherwise their mix is resampled to it. SDL-free;
+// AudioEngine drives it from the device callback.
+class Mixer {
+public:
+    static constexpr int BLOCK_SIZE = 256;
+
+    Mixer(Music& music, Sound& sound);
+
+    // Renders at sampleRate from here on. Rates from MIN_NATIVE_RATE to
+    // MAX_NATIVE_RATE are synthesised directly; others are synthesised at
+    // Music::DEFAULT_SAMPLE_RATE and resampled, unless the ratio is too odd
+    // for the resampler. Not safe while the audio thread is rendering.
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return sampleRate_; }
+    bool resampling() const { return resampling_; }
+
+    // May be called from any thread
+    void setGain(AudioBus bus, float gain);
+    float gain(AudioBus bus) const;
+
+    // Audio thread only. Fills out with the next samples of the mix.
+    void render(float* out, int samples);
+
+    // Below this the naive oscillators alias audibly, and above it the
+    // synths would only spend more time on inaudible detail
+    static constexpr int MIN_NATIVE_RATE = 32000;
+    static constexpr int MAX_NATIVE_RATE = 48000;
+
+private:
+    // The mix at the sources' own rate
+    void renderSources(float* out, int samples);
+    void renderBlock(float* out, int samples);
+
+    Music& music_;
+    Sound& sound_;
+
+    static constexpr size_t BUS_COUNT = static_cast<size_t>(AudioBus::Count);
+    std::array<std::atomic<float>, BUS_COUNT> gains_;
+
+    int sampleRate_ = Music::DEFAULT_SAMPLE_RATE;
+    bool resampling_ = false;
+    Resampler resampler_;
+
+    std::array<float, BLOCK_SIZE> musicBlock_{};
+    std::array<float, BLOCK_SIZE> effectsBlock_{};
+};
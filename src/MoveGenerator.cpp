@@ -0,0 +1,143 @@
+#include "MoveGenerator.h"
+#include <algorithm>
+
+namespace {
+
+// Shape mask shifted so its bounding box starts at the top-left corner
+constexpr uint16_t normalizedMask(const ShapeInfo& shape) {
+    uint16_t mask = 0;
+    for (int y = shape.minY; y <= shape.maxY; y++) {
+        unsigned bits = (shape.mask >> (y * Tetromino::SIZE)) & 0xF;
+        mask |= (bits >> shape.minX) << ((y - shape.minY) * Tetromino::SIZE);
+    }
+    return mask;
+}
+
+// Rotations that cover the same cells (O in every rotation, I/S/Z in
+// opposite ones) map to the lowest such rotation plus a position offset,
+// so each distinct final placement is reported once
+struct Canonical {
+    int8_t rotation;
+    int8_t dx;
+    int8_t dy;
+};
+
+constexpr std::array<std::array<Canonical, 4>, shape_table::TYPES> buildCanonical() {
+    std::array<std::array<Canonical, 4>, shape_table::TYPES> table{};
+    for (int type = 0; type < shape_table::TYPES; type++) {
+        for (int r = 0; r < 4; r++) {
+            const ShapeInfo& shape = shape_table::SHAPES[type][r];
+            int base = r;
+            for (int c = 0; c < r; c++) {
+                if (normalizedMask(shape_table::SHAPES[type][c]) == normalizedMask(shape)) {
+                    base = c;
+                    break;
+                }
+            }
+            const ShapeInfo& baseShape = shape_table::SHAPES[type][base];
+            table[type][r] = {static_cast<int8_t>(base),
+                              static_cast<int8_t>(shape.minX - baseShape.minX),
+                              static_cast<int8_t>(shape.minY - baseShape.minY)};
+        }
+    }
+    return table;
+}
+
+constexpr auto CANONICAL = buildCanonical();
+
+Tetromino canonicalPiece(const Tetromino& piece) {
+    const Canonical& canonical = CANONICAL[static_cast<int>(piece.getType())][piece.getRotation()];
+    Tetromino result(piece.getType());
+    for (int r = 0; r < canonical.rotation; r++) {
+        result.rotateClockwise();
+    }
+    result.setPosition(piece.getX() + canonical.dx, piece.getY() + canonical.dy);
+    return result;
+}
+
+} // namespace
+
+MoveGenerator::MoveGenerator() {
+    nodes_.reserve(STATE_COUNT);
+}
+
+int MoveGenerator::stateIndex(const Tetromino& piece) {
+    int x = piece.getX() + X_OFFSET;
+    int y = piece.getY() + Y_OFFSET;
+    if (x < 0 || x >= X_RANGE || y < 0 || y >= Y_RANGE) {
+        return -1;
+    }
+    return (y * X_RANGE + x) * 4 + piece.getRotation();
+}
+
+bool MoveGenerator::insert(StateSet& set, const Tetromino& piece) {
+    int index = stateIndex(piece);
+    if (index < 0) return false;
+
+    uint64_t bit = uint64_t(1) << (index & 63);
+    uint64_t& word = set[index >> 6];
+    if (word & bit) return false;
+
+    word |= bit;
+    return true;
+}
+
+void MoveGenerator::visit(const Board& board, const Tetromino& piece, int32_t parent, Input input) {
+    if (!board.isValidPosition(piece)) return;
+    if (!insert(visited_, piece)) return;
+    nodes_.push_back({piece, parent, input});
+}
+
+const std::vector<Placement>& MoveGenerator::generate(const Board& board, const Tetromino& piece) {
+    visited_.fill(0);
+    placed_.fill(0);
+    nodes_.clear();
+    placements_.clear();
+
+    visit(board, piece, -1, Input::None);
+
+    // nodes_ doubles as the BFS queue
+    for (size_t i = 0; i < nodes_.size(); i++) {
+        const Tetromino current = nodes_[i].piece;
+        int32_t parent = static_cast<int32_t>(i);
+
+        Tetromino down = current;
+        down.move(0, 1);
+        if (board.isValidPosition(down)) {
+            visit(board, down, parent, Input::SoftDrop);
+        } else if (insert(placed_, canonicalPiece(current))) {
+            placements_.push_back({current, parent});
+        }
+
+        Tetromino left = current;
+        left.move(-1, 0);
+        visit(board, left, parent, Input::Left);
+
+        Tetromino right = current;
+        right.move(1, 0);
+        visit(board, right, parent, Input::Right);
+
+        Tetromino rotated = current;
+        if (Simulation::rotateWithKicks(board, rotated)) {
+            visit(board, rotated, parent, Input::Rotate);
+        }
+    }
+
+    return placements_;
+}
+
+std::vector<Input> MoveGenerator::pathTo(const Placement& placement) const {
+    std::vector<Input> path;
+    for (int32_t node = placement.node; nodes_[node].parent >= 0; node = nodes_[node].parent) {
+        path.push_back(nodes_[node].input);
+    }
+    std::reverse(path.begin(), path.end());
+
+    // A hard drop from the last sideways move or rotation lands in the same spot
+    while (!path.empty() && path.back() == Input::SoftDrop) {
+        path.pop_back();
+    }
+    path.push_back(Input::HardDrop);
+
+    return path;
+}
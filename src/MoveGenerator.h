@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Board.h"
+#include "Simulation.h"
+#include "Tetromino.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// A reachable resting position for a piece
+struct Placement {
+    Tetromino piece;
+    int32_t node = 0;   // Search node that reached it, used by MoveGenerator::pathTo
+};
+
+// Enumerates every final placement reachable from a piece's current
+// position using the same moves a player has: left, right, soft drop and
+// clockwise rotation with the game's wall kicks. The search is a
+// breadth-first walk over (x, y, rotation) states, so tucks and spins
+// under overhangs are found and every path is as short as possible.
+//
+// The generator owns its buffers; reuse one instance to avoid allocating.
+class MoveGenerator {
+public:
+    MoveGenerator();
+
+    // Results stay valid until the next call
+    const std::vector<Placement>& generate(const Board& board, const Tetromino& piece);
+
+    // Inputs that take the piece from its start position to placement and
+    // lock it there. The trailing run of soft drops is folded into a hard drop.
+    std::vector<Input> pathTo(const Placement& placement) const;
+
+private:
+    // Pieces live at x in [-3, WIDTH - 1]; kicks can lift them a little above row 0
+    static constexpr int X_OFFSET = Tetromino::SIZE - 1;
+    static constexpr int Y_OFFSET = Tetromino::SIZE;
+    static constexpr int X_RANGE = Board::WIDTH + X_OFFSET;
+    static constexpr int Y_RANGE = Board::HEIGHT + Y_OFFSET;
+    static constexpr int STATE_COUNT = X_RANGE * Y_RANGE * 4;
+
+    using StateSet = std::array<uint64_t, (STATE_COUNT + 63) / 64>;
+
+    struct Node {
+        Tetromino piece;
+        int32_t parent;
+        Input input;
+    };
+
+    static int stateIndex(const Tetromino& piece);
+
+    // Marks a state, returning false if it was already set or out of range
+    static bool insert(StateSet& set, const Tetromino& piece);
+
+    void visit(const Board& board, const Tetromino& piece, int32_t parent, Input input);
+
+    StateSet visited_;
+    StateSet placed_;
+    std::vector<Node> nodes_;
+    std::vector<Placement> placements_;
+};
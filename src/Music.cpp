@@ -1,276 +1,429 @@
 #include "Music.h"
+#include <algorithm>
 #include <cmath>
-#include <random>
 
-Music::Music() {
-    // Initialize bass pattern (E minor pentatonic style)
-    // Pattern: E2, rest, E2, rest, G2, rest, E2, A2, rest, E2, rest, rest, G2, rest, E2, rest
-    bassPattern_ = {40, 0, 40, 0, 43, 0, 40, 45, 0, 40, 0, 0, 43, 0, 40, 0};
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TETRIS_MUSIC_SSE2 1
+#endif
 
-    // Arpeggio notes (E minor chord with extensions)
-    arpNotes_ = {52, 55, 59, 62, 64, 67, 71, 74}; // E4, G4, B4, D5, E5, G5, B5, D6
-}
+namespace {
+
+constexpr int SINE_TABLE_SIZE = 2048;
 
-Music::~Music() {
-    shutdown();
+// One period of sine plus a guard entry, so interpolation never wraps
+const std::array<float, SINE_TABLE_SIZE + 1>& sineTable() {
+    static const std::array<float, SINE_TABLE_SIZE + 1> table = [] {
+        std::array<float, SINE_TABLE_SIZE + 1> values{};
+        for (int i = 0; i <= SINE_TABLE_SIZE; i++) {
+            values[i] = static_cast<float>(std::sin(2.0 * M_PI * i / SINE_TABLE_SIZE));
+        }
+        return values;
+    }();
+    return table;
 }
 
-bool Music::init() {
-    SDL_AudioSpec desired;
-    SDL_memset(&desired, 0, sizeof(desired));
-    desired.freq = SAMPLE_RATE;
-    desired.format = AUDIO_F32SYS;
-    desired.channels = 1;
-    desired.samples = 2048;
-    desired.callback = audioCallback;
-    desired.userdata = this;
-
-    audioDevice_ = SDL_OpenAudioDevice(nullptr, 0, &desired, &audioSpec_, 0);
-    if (audioDevice_ == 0) {
-        return false;
-    }
+// Four samples of one voice. The SSE2 and scalar versions do the same float
+// operations in the same order, so they produce identical output.
+#if TETRIS_MUSIC_SSE2
 
-    return true;
-}
+struct F4 {
+    __m128 v;
+};
 
-void Music::shutdown() {
-    stop();
-    if (audioDevice_ != 0) {
-        SDL_CloseAudioDevice(audioDevice_);
-        audioDevice_ = 0;
-    }
-}
+F4 splat(float x) { return {_mm_set1_ps(x)}; }
+F4 load(const float* p) { return {_mm_loadu_ps(p)}; }
+void store(float* p, F4 a) { _mm_storeu_ps(p, a.v); }
 
-void Music::play() {
-    if (audioDevice_ != 0) {
-        playing_ = true;
-        SDL_PauseAudioDevice(audioDevice_, 0);
-    }
+F4 operator+(F4 a, F4 b) { return {_mm_add_ps(a.v, b.v)}; }
+F4 operator-(F4 a, F4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+F4 operator*(F4 a, F4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+F4 min(F4 a, F4 b) { return {_mm_min_ps(a.v, b.v)}; }
+
+// Fractional part of non-negative values
+F4 frac(F4 a) { return {_mm_sub_ps(a.v, _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v)))}; }
+
+// 1 below half a cycle, -1 from there on
+F4 square(F4 phase) {
+    __m128 high = _mm_cmpge_ps(phase.v, _mm_set1_ps(0.5f));
+    return {_mm_sub_ps(_mm_set1_ps(1.0f), _mm_and_ps(high, _mm_set1_ps(2.0f)))};
 }
 
-void Music::stop() {
-    playing_ = false;
-    if (audioDevice_ != 0) {
-        SDL_PauseAudioDevice(audioDevice_, 1);
-    }
+F4 sine(F4 phase) {
+    const std::array<float, SINE_TABLE_SIZE + 1>& table = sineTable();
+    __m128 position = _mm_mul_ps(phase.v, _mm_set1_ps(static_cast<float>(SINE_TABLE_SIZE)));
+    __m128i index = _mm_cvttps_epi32(position);
+    __m128 fraction = _mm_sub_ps(position, _mm_cvtepi32_ps(index));
+
+    // No gather in SSE2, so the table reads are scalar
+    alignas(16) int32_t indices[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(indices), index);
+    __m128 a = _mm_setr_ps(table[indices[0]], table[indices[1]], table[indices[2]], table[indices[3]]);
+    __m128 b = _mm_setr_ps(table[indices[0] + 1], table[indices[1] + 1], table[indices[2] + 1], table[indices[3] + 1]);
+    return {_mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), fraction))};
 }
 
-void Music::setVolume(float volume) {
-    volume_ = std::max(0.0f, std::min(1.0f, volume));
+// xorshift32 in every lane, mapped to [-1, 1)
+F4 nextNoise(uint32_t* state) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), x);
+    return {_mm_mul_ps(_mm_cvtepi32_ps(x), _mm_set1_ps(1.0f / 2147483648.0f))};
 }
 
-void Music::audioCallback(void* userdata, Uint8* stream, int len) {
-    Music* music = static_cast<Music*>(userdata);
-    float* floatStream = reinterpret_cast<float*>(stream);
-    int samples = len / sizeof(float);
+#else
 
-    for (int i = 0; i < samples; i++) {
-        if (music->playing_) {
-            floatStream[i] = music->generateSample() * music->volume_;
-        } else {
-            floatStream[i] = 0.0f;
-        }
-    }
-}
+struct F4 {
+    float v[4];
+};
 
-float Music::generateSample() {
-    double t = sampleIndex_ / SAMPLE_RATE;
-    sampleIndex_++;
+F4 splat(float x) { return {{x, x, x, x}}; }
+F4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+void store(float* p, F4 a) { std::copy(a.v, a.v + 4, p); }
 
-    // Calculate position in the music
-    float barPosition = std::fmod(t, BAR_DURATION) / BAR_DURATION;
-    float beatPosition = std::fmod(t, BEAT_DURATION) / BEAT_DURATION;
-    int step = static_cast<int>(barPosition * PATTERN_LENGTH) % PATTERN_LENGTH;
-    float stepPosition = std::fmod(barPosition * PATTERN_LENGTH, 1.0f);
+template <typename Op>
+F4 lanewise(F4 a, F4 b, Op op) {
+    return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}};
+}
 
-    currentBar_ = static_cast<int>(t / BAR_DURATION) % 8;
+F4 operator+(F4 a, F4 b) { return lanewise(a, b, [](float x, float y) { return x + y; }); }
+F4 operator-(F4 a, F4 b) { return lanewise(a, b, [](float x, float y) { return x - y; }); }
+F4 operator*(F4 a, F4 b) { return lanewise(a, b, [](float x, float y) { return x * y; }); }
+F4 min(F4 a, F4 b) { return lanewise(a, b, [](float x, float y) { return y < x ? y : x; }); }
 
-    float sample = 0.0f;
+F4 frac(F4 a) {
+    return lanewise(a, a, [](float x, float) { return x - static_cast<float>(static_cast<int32_t>(x)); });
+}
 
-    // Drums
-    sample += generateKick(beatPosition) * 0.5f;
-    sample += generateSnare(beatPosition) * 0.3f;
-    sample += generateHiHat(stepPosition) * 0.15f;
+F4 square(F4 phase) {
+    return lanewise(phase, phase, [](float x, float) { return x >= 0.5f ? -1.0f : 1.0f; });
+}
 
-    // Bass (comes in on bar 2)
-    if (currentBar_ >= 1) {
-        sample += generateBass(t) * 0.35f;
-    }
+F4 sine(F4 phase) {
+    const std::array<float, SINE_TABLE_SIZE + 1>& table = sineTable();
+    return lanewise(phase, phase, [&](float x, float) {
+        float position = x * static_cast<float>(SINE_TABLE_SIZE);
+        int32_t index = static_cast<int32_t>(position);
+        float fraction = position - static_cast<float>(index);
+        return table[index] + (table[index + 1] - table[index]) * fraction;
+    });
+}
 
-    // Arpeggio (comes in on bar 3)
-    if (currentBar_ >= 2) {
-        sample += generateArpeggio(t) * 0.2f;
+F4 nextNoise(uint32_t* state) {
+    F4 result;
+    for (int lane = 0; lane < 4; lane++) {
+        uint32_t x = state[lane];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state[lane] = x;
+        result.v[lane] = static_cast<float>(static_cast<int32_t>(x)) * (1.0f / 2147483648.0f);
     }
+    return result;
+}
 
-    // Lead melody (comes in on bar 5)
-    if (currentBar_ >= 4) {
-        sample += generateLead(t) * 0.25f;
-    }
+#endif
 
-    // Pad for atmosphere
-    sample += generatePad(t) * 0.1f;
+// base, base + step, base + 2 step, base + 3 step
+F4 ramp(float base, float step) {
+    float offsets[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    return splat(base) + splat(step) * load(offsets);
+}
 
-    // Soft clip to avoid harsh distortion
-    sample = std::tanh(sample);
+// start, start * ratio, start * ratio^2, start * ratio^3
+F4 geometric(float start, float ratio) {
+    float powers[4] = {1.0f, ratio, ratio * ratio, ratio * ratio * ratio};
+    return splat(start) * load(powers);
+}
 
-    return sample;
+F4 saw(F4 phase) {
+    return splat(2.0f) * phase - splat(1.0f);
 }
 
-float Music::generateKick(float beatPos) {
-    if (beatPos > 0.15f) return 0.0f;
+// Rational tanh approximation: unity gain near zero, easing into +-1 at +-3
+float softClip(float x) {
+    x = std::clamp(x, -3.0f, 3.0f);
+    float x2 = x * x;
+    return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+}
 
-    float t = beatPos * BEAT_DURATION;
-    float freq = 150.0f * std::exp(-t * 40.0f) + 45.0f;
-    float env = std::exp(-t * 15.0f);
+// Adds voice(i), four samples at a time, to out[0, samples). voice keeps
+// its own lane state and is called once per group of four.
+template <typename Voice>
+void addVoice(float* out, int samples, Voice voice) {
+    for (int i = 0; i < samples; i += 4) {
+        F4 value = voice(i);
+        if (samples - i >= 4) {
+            store(out + i, load(out + i) + value);
+        } else {
+            float tail[4];
+            store(tail, value);
+            for (int lane = 0; lane < samples - i; lane++) {
+                out[i + lane] += tail[lane];
+            }
+        }
+    }
+}
 
-    phaseKick_ += freq / SAMPLE_RATE;
-    if (phaseKick_ > 1.0f) phaseKick_ -= 1.0f;
+// Samples, from the first, whose time t0 + i * dt is still within length
+int activeSamples(float t0, float dt, float length, int samples) {
+    if (t0 > length) return 0;
+    return std::min(samples, static_cast<int>((length - t0) / dt) + 1);
+}
 
-    return std::sin(phaseKick_ * 2.0f * M_PI) * env;
+// Advances a phase by whole samples, in double so long segments don't drift
+float advancePhase(float phase, float increment, int samples) {
+    double next = phase + static_cast<double>(increment) * samples;
+    return static_cast<float>(next - std::floor(next));
 }
 
-float Music::generateSnare(float beatPos) {
-    // Snare on beats 2 and 4
-    float snarePos = std::fmod(beatPos + 0.5f, 1.0f);
-    if (snarePos > 0.12f) return 0.0f;
+} // namespace
 
-    float t = snarePos * BEAT_DURATION;
-    float env = std::exp(-t * 20.0f);
+Music::Music() {
+    // Initialize bass pattern (E minor pentatonic style)
+    // Pattern: E2, rest, E2, rest, G2, rest, E2, A2, rest, E2, rest, rest, G2, rest, E2, rest
+    bassPattern_ = {40, 0, 40, 0, 43, 0, 40, 45, 0, 40, 0, 0, 43, 0, 40, 0};
 
-    // Mix of tone and noise
-    float tone = std::sin(phaseSnare_ * 2.0f * M_PI * 200.0f) * 0.3f;
-    phaseSnare_ += 1.0f / SAMPLE_RATE;
+    // Arpeggio notes (E minor chord with extensions)
+    arpNotes_ = {52, 55, 59, 62, 64, 67, 71, 74}; // E4, G4, B4, D5, E5, G5, B5, D6
 
-    float noiseVal = noise() * 0.7f;
+    // MIDI note to frequency (A4 = 440Hz = note 69)
+    for (int note = 0; note < static_cast<int>(noteFreqs_.size()); note++) {
+        noteFreqs_[note] = 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
+    }
 
-    return (tone + noiseVal) * env;
+    noiseState_ = {42u, 0x9E3779B9u, 0x7F4A7C15u, 0x2545F491u};
+    sineTable();
 }
 
-float Music::generateHiHat(float stepPos) {
-    if (stepPos > 0.3f) return 0.0f;
-
-    float t = stepPos * (BEAT_DURATION / 4.0f);
-    float env = std::exp(-t * 50.0f);
-
-    return noise() * env;
+void Music::setSampleRate(int sampleRate) {
+    sampleRate_ = sampleRate;
+    stepNumerator_ = stepNumerator(sampleRate);
+    sampleIndex_ = 0;
 }
 
-float Music::generateBass(float t) {
-    float barPos = std::fmod(t, BAR_DURATION) / BAR_DURATION;
-    int step = static_cast<int>(barPos * PATTERN_LENGTH) % PATTERN_LENGTH;
-    float stepPos = std::fmod(barPos * PATTERN_LENGTH, 1.0f);
-
-    int note = bassPattern_[step];
-    if (note == 0) return 0.0f;
-
-    float freq = noteToFreq(note);
-
-    // Envelope
-    float env = std::exp(-stepPos * 8.0f);
-
-    phaseBass_ += freq / SAMPLE_RATE;
-    if (phaseBass_ > 1.0f) phaseBass_ -= 1.0f;
-
-    // Mix of saw and square for thick bass
-    float sawVal = saw(phaseBass_);
-    float sqVal = square(phaseBass_);
+void Music::setVolume(float volume) {
+    volume_ = std::max(0.0f, std::min(1.0f, volume));
+}
 
-    return (sawVal * 0.6f + sqVal * 0.4f) * env;
+void Music::setLoop(const float* samples) {
+    loop_.store(samples, std::memory_order_release);
 }
 
-float Music::generateArpeggio(float t) {
-    // Fast arpeggio - 16th notes
-    float stepDuration = BEAT_DURATION / 4.0f;
-    int arpStep = static_cast<int>(t / stepDuration) % 8;
-    float stepPos = std::fmod(t / stepDuration, 1.0f);
+void Music::render(float* out, int samples) {
+    // The loop starts where synthesis would be, so switching over mid-track
+    // stays in time
+    if (const float* loop = loop_.load(std::memory_order_acquire)) {
+        const uint64_t length = loopSamples();
+        const uint64_t crossfade = static_cast<uint64_t>(loopCrossfadeSamples(sampleRate_));
+        while (samples > 0) {
+            // The first pass is exactly the live track; after a wrap the
+            // opening comes from the crossfaded copy past the loop's end
+            uint64_t position = sampleIndex_ % length;
+            const float* source = loop + position;
+            uint64_t end = length;
+            if (sampleIndex_ >= length && position < crossfade) {
+                source = loop + length + position;
+                end = crossfade;
+            }
+            int count = static_cast<int>(std::min<uint64_t>(samples, end - position));
+            for (int i = 0; i < count; i++) {
+                out[i] = source[i] * volume_;
+            }
+
+            out += count;
+            samples -= count;
+            sampleIndex_ += count;
+        }
+        return;
+    }
 
-    int note = arpNotes_[arpStep];
-    float freq = noteToFreq(note);
+    while (samples > 0) {
+        // Cut the block where the next step starts
+        uint64_t step = sampleIndex_ * STEP_DENOMINATOR / stepNumerator_;
+        uint64_t nextStepStart = ((step + 1) * stepNumerator_ + STEP_DENOMINATOR - 1) / STEP_DENOMINATOR;
+        int count = static_cast<int>(std::min<uint64_t>(
+            {static_cast<uint64_t>(samples), static_cast<uint64_t>(BLOCK_SIZE), nextStepStart - sampleIndex_}));
 
-    // Short plucky envelope
-    float env = std::exp(-stepPos * 12.0f);
+        renderSegment(block_.data(), count);
 
-    phaseArp_ += freq / SAMPLE_RATE;
-    if (phaseArp_ > 1.0f) phaseArp_ -= 1.0f;
+        // Soft clip to avoid harsh distortion
+        for (int i = 0; i < count; i++) {
+            out[i] = softClip(block_[i]) * volume_;
+        }
 
-    // Bright saw wave
-    return saw(phaseArp_) * env * 0.7f;
+        out += count;
+        samples -= count;
+        sampleIndex_ += count;
+    }
 }
 
-float Music::generateLead(float t) {
-    // Simple melody pattern (2 bars)
-    float melodyDuration = BAR_DURATION * 2;
-    float melodyPos = std::fmod(t, melodyDuration) / melodyDuration;
-
-    // Melody notes (16 half-beats over 2 bars)
-    static const int melody[] = {
-        64, 64, 67, 67, 71, 71, 69, 67, // E5, E5, G5, G5, B5, B5, A5, G5
-        64, 67, 71, 74, 72, 71, 69, 67  // E5, G5, B5, D6, C6, B5, A5, G5
-    };
+void Music::fillNoise(int samples) {
+    for (int i = 0; i < samples; i += 4) {
+        store(noise_.data() + i, nextNoise(noiseState_.data()));
+    }
+}
 
-    int noteIndex = static_cast<int>(melodyPos * 16) % 16;
-    float notePos = std::fmod(melodyPos * 16, 1.0f);
+void Music::renderSegment(float* out, int samples) {
+    std::fill(out, out + samples, 0.0f);
+
+    uint64_t step = sampleIndex_ * STEP_DENOMINATOR / stepNumerator_;
+    int stepInBar = static_cast<int>(step % PATTERN_LENGTH);
+    int bar = static_cast<int>(step / PATTERN_LENGTH % 8);
+
+    // Time since the step began, in seconds and as a fraction of the step
+    const float stepDuration = BEAT_DURATION / 4.0f;
+    const float dt = 1.0f / sampleRate_;
+    double stepStart = static_cast<double>(step * stepNumerator_) / STEP_DENOMINATOR;
+    float t0 = static_cast<float>((sampleIndex_ - stepStart) / sampleRate_);
+    float stepPos = t0 / stepDuration;
+
+    // Kick on every beat, with a falling pitch
+    int kickSamples = stepInBar % 4 == 0 ? activeSamples(t0, dt, 0.15f * BEAT_DURATION, samples) : 0;
+    if (kickSamples > 0) {
+        F4 t = ramp(t0, dt);
+        F4 pitch = geometric(std::exp(-40.0f * t0), std::exp(-40.0f * dt));
+        F4 env = geometric(std::exp(-15.0f * t0) * 0.5f, std::exp(-15.0f * dt));
+        F4 tStep = splat(4.0f * dt);
+        F4 pitchStep = splat(std::pow(std::exp(-40.0f * dt), 4.0f));
+        F4 envStep = splat(std::pow(std::exp(-15.0f * dt), 4.0f));
+
+        addVoice(out, kickSamples, [&](int) {
+            // Integral of 150 e^(-40 t) + 45 Hz
+            F4 phase = frac(splat(45.0f) * t + splat(150.0f / 40.0f) * (splat(1.0f) - pitch));
+            F4 value = sine(phase) * env;
+            t = t + tStep;
+            pitch = pitch * pitchStep;
+            env = env * envStep;
+            return value;
+        });
+    }
 
-    int note = melody[noteIndex];
-    float freq = noteToFreq(note);
+    // Snare on the off-beats and hi-hat on every step share one noise buffer
+    int snareSamples = stepInBar % 4 == 2 ? activeSamples(t0, dt, 0.12f * BEAT_DURATION, samples) : 0;
+    int hatSamples = activeSamples(t0, dt, 0.3f * stepDuration, samples);
+    if (snareSamples > 0 || hatSamples > 0) {
+        fillNoise(std::max(snareSamples, hatSamples));
+    }
 
-    // Smooth envelope
-    float attack = std::min(notePos * 20.0f, 1.0f);
-    float decay = std::exp(-notePos * 3.0f);
-    float env = attack * decay;
+    if (snareSamples > 0) {
+        F4 phase = frac(ramp(200.0f * t0, 200.0f * dt));
+        F4 env = geometric(std::exp(-20.0f * t0) * 0.3f, std::exp(-20.0f * dt));
+        F4 phaseStep = splat(4.0f * 200.0f * dt);
+        F4 envStep = splat(std::pow(std::exp(-20.0f * dt), 4.0f));
+
+        addVoice(out, snareSamples, [&](int i) {
+            F4 value = (sine(phase) * splat(0.3f) + load(noise_.data() + i) * splat(0.7f)) * env;
+            phase = frac(phase + phaseStep);
+            env = env * envStep;
+            return value;
+        });
+    }
 
-    phaseLead_ += freq / SAMPLE_RATE;
-    if (phaseLead_ > 1.0f) phaseLead_ -= 1.0f;
+    if (hatSamples > 0) {
+        F4 env = geometric(std::exp(-50.0f * t0) * 0.15f, std::exp(-50.0f * dt));
+        F4 envStep = splat(std::pow(std::exp(-50.0f * dt), 4.0f));
 
-    // Mix of square and saw for synth lead
-    float sqVal = square(phaseLead_);
-    float sawVal = saw(phaseLead_);
+        addVoice(out, hatSamples, [&](int i) {
+            F4 value = load(noise_.data() + i) * env;
+            env = env * envStep;
+            return value;
+        });
+    }
 
-    // Add slight detuned oscillator for width
-    float detune = 1.005f;
-    static float phase2 = 0;
-    phase2 += (freq * detune) / SAMPLE_RATE;
-    if (phase2 > 1.0f) phase2 -= 1.0f;
+    // Bass (comes in on bar 2): saw and square
+    int bassNote = bassPattern_[stepInBar];
+    if (bar >= 1 && bassNote != 0) {
+        float increment = noteToFreq(bassNote) / sampleRate_;
+        float decay = std::exp(-8.0f * dt / stepDuration);
+        F4 phase = frac(ramp(phaseBass_, increment));
+        F4 env = geometric(std::exp(-8.0f * stepPos) * 0.35f, decay);
+        F4 phaseStep = splat(4.0f * increment);
+        F4 envStep = splat(std::pow(decay, 4.0f));
+
+        addVoice(out, samples, [&](int) {
+            F4 value = (saw(phase) * splat(0.6f) + square(phase) * splat(0.4f)) * env;
+            phase = frac(phase + phaseStep);
+            env = env * envStep;
+            return value;
+        });
+        phaseBass_ = advancePhase(phaseBass_, increment, samples);
+    }
 
-    float osc2 = saw(phase2);
+    // Arpeggio (comes in on bar 3): plucked saw
+    if (bar >= 2) {
+        float increment = noteToFreq(arpNotes_[step % 8]) / sampleRate_;
+        float decay = std::exp(-12.0f * dt / stepDuration);
+        F4 phase = frac(ramp(phaseArp_, increment));
+        F4 env = geometric(std::exp(-12.0f * stepPos) * 0.7f * 0.2f, decay);
+        F4 phaseStep = splat(4.0f * increment);
+        F4 envStep = splat(std::pow(decay, 4.0f));
+
+        addVoice(out, samples, [&](int) {
+            F4 value = saw(phase) * env;
+            phase = frac(phase + phaseStep);
+            env = env * envStep;
+            return value;
+        });
+        phaseArp_ = advancePhase(phaseArp_, increment, samples);
+    }
 
-    return ((sqVal * 0.4f + sawVal * 0.3f + osc2 * 0.3f)) * env;
-}
+    // Lead melody (comes in on bar 5): 16 half-beat notes over 2 bars
+    if (bar >= 4) {
+        static const int melody[] = {
+            64, 64, 67, 67, 71, 71, 69, 67, // E5, E5, G5, G5, B5, B5, A5, G5
+            64, 67, 71, 74, 72, 71, 69, 67  // E5, G5, B5, D6, C6, B5, A5, G5
+        };
+        int stepInMelody = static_cast<int>(step % 32);
+        float freq = noteToFreq(melody[stepInMelody / 2]);
+        float increment = freq / sampleRate_;
+        float detunedIncrement = freq * 1.005f / sampleRate_;
+
+        // Position within the note, which lasts two steps
+        float notePos = (stepInMelody % 2 + stepPos) / 2.0f;
+        float noteDelta = dt / (2.0f * stepDuration);
+        float decay = std::exp(-3.0f * noteDelta);
+
+        F4 phase = frac(ramp(phaseLead_, increment));
+        F4 detuned = frac(ramp(phaseLeadDetuned_, detunedIncrement));
+        F4 attack = ramp(notePos * 20.0f, noteDelta * 20.0f);
+        F4 env = geometric(std::exp(-3.0f * notePos) * 0.25f, decay);
+        F4 phaseStep = splat(4.0f * increment);
+        F4 detunedStep = splat(4.0f * detunedIncrement);
+        F4 attackStep = splat(4.0f * noteDelta * 20.0f);
+        F4 envStep = splat(std::pow(decay, 4.0f));
+
+        addVoice(out, samples, [&](int) {
+            F4 mix = square(phase) * splat(0.4f) + saw(phase) * splat(0.3f) + saw(detuned) * splat(0.3f);
+            F4 value = mix * min(attack, splat(1.0f)) * env;
+            phase = frac(phase + phaseStep);
+            detuned = frac(detuned + detunedStep);
+            attack = attack + attackStep;
+            env = env * envStep;
+            return value;
+        });
+        phaseLead_ = advancePhase(phaseLead_, increment, samples);
+        phaseLeadDetuned_ = advancePhase(phaseLeadDetuned_, detunedIncrement, samples);
+    }
 
-float Music::generatePad(float t) {
-    // Slow evolving pad for atmosphere
-    // E minor chord: E3, G3, B3
+    // Pad for atmosphere: E minor chord (E3, G3, B3) with a slow LFO per
+    // voice, which barely moves within a segment so it is held constant
     static const int padNotes[] = {40, 43, 47};
-    float sample = 0.0f;
-
-    for (int i = 0; i < 3; i++) {
-        float freq = noteToFreq(padNotes[i]);
-        float phase = std::fmod(t * freq, 1.0f);
-
-        // Slow LFO for movement
-        float lfo = std::sin(t * 0.5f + i * 0.5f) * 0.3f + 0.7f;
-
-        sample += std::sin(phase * 2.0f * M_PI) * lfo;
+    double seconds = static_cast<double>(sampleIndex_) / sampleRate_;
+    for (int voice = 0; voice < 3; voice++) {
+        float increment = noteToFreq(padNotes[voice]) / sampleRate_;
+        float lfo = static_cast<float>(std::sin(seconds * 0.5 + voice * 0.5)) * 0.3f + 0.7f;
+        F4 phase = frac(ramp(phasePad_[voice], increment));
+        F4 gain = splat(lfo * 0.1f / 3.0f);
+        F4 phaseStep = splat(4.0f * increment);
+
+        addVoice(out, samples, [&](int) {
+            F4 value = sine(phase) * gain;
+            phase = frac(phase + phaseStep);
+            return value;
+        });
+        phasePad_[voice] = advancePhase(phasePad_[voice], increment, samples);
     }
-
-    return sample / 3.0f;
-}
-
-float Music::noteToFreq(int note) {
-    // MIDI note to frequency (A4 = 440Hz = note 69)
-    return 440.0f * std::pow(2.0f, (note - 69) / 12.0f);
-}
-
-float Music::saw(float phase) {
-    return 2.0f * phase - 1.0f;
-}
-
-float Music::square(float phase) {
-    return phase < 0.5f ? 1.0f : -1.0f;
-}
-
-float Music::noise() {
-    static std::mt19937 gen(42);
-    static std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
-    return dist(gen);
 }
@@ -1,68 +1,103 @@
 #pragma once
 
-#include <SDL.h>
-#include <vector>
 #include <array>
 #include <atomic>
+#include <cstdint>
 
+// Procedural EDM track. Output goes through AudioEngine's music bus.
+//
+// The track is rendered a block at a time: each block is cut at sixteenth
+// note boundaries, so within a segment every voice plays one note and is a
+// phase accumulator with a recursive envelope. Voices are computed four
+// samples at a time with SSE2 where available, from precomputed sine and
+// note frequency tables.
 class Music {
 public:
     Music();
-    ~Music();
 
-    bool init();
-    void shutdown();
+    // Synthesises at sampleRate from here on, restarting the track. Not safe
+    // while the audio thread is rendering.
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return sampleRate_; }
 
-    void play();
-    void stop();
+    // The mixer keeps the track silent and paused while stopped
+    void play() { playing_ = true; }
+    void stop() { playing_ = false; }
+    bool isPlaying() const { return playing_; }
     void setVolume(float volume);
 
-private:
-    static void audioCallback(void* userdata, Uint8* stream, int len);
+    // Synthesises the next samples of the track (volume applied) into out,
+    // or copies them from the pre-rendered loop once one is set
+    void render(float* out, int samples);
+
+    // Plays from samples, one full loop of the track at volume 1 and at this
+    // sample rate followed by a crossfaded copy of its opening, as made by
+    // MusicLoopCache, instead of synthesising. samples must stay valid while
+    // the track can play. Safe to call while the audio thread is rendering.
+    void setLoop(const float* samples);
+
+    // The arrangement repeats every 8 bars: exactly 15 s, 661500 samples at
+    // 44100 Hz
+    static constexpr uint64_t loopSamples(int sampleRate) {
+        return 8 * PATTERN_LENGTH * stepNumerator(sampleRate) / STEP_DENOMINATOR;
+    }
+    uint64_t loopSamples() const { return loopSamples(sampleRate_); }
 
-    float generateSample();
-    float generateKick(float t);
-    float generateSnare(float t);
-    float generateHiHat(float t);
-    float generateBass(float t);
-    float generateLead(float t);
-    float generateArpeggio(float t);
-    float generatePad(float t);
+    // Length of the crossfaded opening played on every pass but the first,
+    // which blends in the tail that would have followed the loop: 250 ms
+    static constexpr int loopCrossfadeSamples(int sampleRate) { return sampleRate / 4; }
 
-    float noteToFreq(int note);
-    float saw(float phase);
-    float square(float phase);
-    float noise();
+    static constexpr int DEFAULT_SAMPLE_RATE = 44100;
 
-    SDL_AudioDeviceID audioDevice_ = 0;
-    SDL_AudioSpec audioSpec_;
+private:
+    // Adds every voice for samples that all lie within one step
+    void renderSegment(float* out, int samples);
+    void fillNoise(int samples);
+
+    float noteToFreq(int note) const { return noteFreqs_[note]; }
 
     std::atomic<bool> playing_{false};
+    std::atomic<const float*> loop_{nullptr};
     float volume_ = 0.5f;
 
-    double sampleIndex_ = 0.0;
+    uint64_t sampleIndex_ = 0;
 
     // Timing
-    static constexpr int SAMPLE_RATE = 44100;
-    static constexpr float BPM = 128.0f;
+    int sampleRate_ = DEFAULT_SAMPLE_RATE;
+    static constexpr int BPM = 128;
     static constexpr float BEAT_DURATION = 60.0f / BPM;
-    static constexpr float BAR_DURATION = BEAT_DURATION * 4;
 
     // Musical elements
     static constexpr int PATTERN_LENGTH = 16; // 16th notes per bar
 
+    // A 16th note lasts stepNumerator_ / STEP_DENOMINATOR samples (5167.97
+    // at 44100 Hz), kept as a fraction so step boundaries never drift
+    static constexpr uint64_t stepNumerator(int sampleRate) { return static_cast<uint64_t>(sampleRate) * 60 / 4; }
+    static constexpr uint64_t STEP_DENOMINATOR = BPM;
+    uint64_t stepNumerator_ = stepNumerator(DEFAULT_SAMPLE_RATE);
+
+    static constexpr int BLOCK_SIZE = 256;
+
     // Bass pattern (MIDI notes, 0 = rest)
     std::array<int, PATTERN_LENGTH> bassPattern_;
 
     // Arpeggio notes
     std::array<int, 8> arpNotes_;
 
-    // Current musical state
-    int currentBar_ = 0;
-    float phaseKick_ = 0;
-    float phaseSnare_ = 0;
+    // MIDI note to frequency
+    std::array<float, 128> noteFreqs_;
+
+    // Oscillator phases in cycles, in [0, 1)
     float phaseBass_ = 0;
-    float phaseLead_ = 0;
     float phaseArp_ = 0;
-    float phasePad_ = 0;
+    float phaseLead_ = 0;
+    float phaseLeadDetuned_ = 0;
+    std::array<float, 3> phasePad_{};
+
+    // One xorshift32 generator per SIMD lane
+    std::array<uint32_t, 4> noiseState_;
+
+    // Scratch for the mix and the noise shared by snare and hi-hat
+    std::array<float, BLOCK_SIZE> block_{};
+    std::array<float, BLOCK_SIZE> noise_{};
 };
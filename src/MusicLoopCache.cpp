@@ -0,0 +1,177 @@
+#include "MusicLoopCache.h"
+#include "Music.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char MAGIC[4] = {'T', 'M', 'U', 'S'};
+constexpr size_t HEADER_SIZE = 20;
+constexpr float BYTE_ORDER_TAG = 1.0f;
+
+void putU32(unsigned char* out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+uint32_t getU32(const unsigned char* in) {
+    return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 |
+           static_cast<uint32_t>(in[2]) << 16 | static_cast<uint32_t>(in[3]) << 24;
+}
+
+// A header this build of the synth would have written at sampleRate
+bool validHeader(const unsigned char* header, size_t fileSize, int sampleRate) {
+    size_t samples = static_cast<size_t>(Music::loopSamples(sampleRate));
+    size_t stored = samples + static_cast<size_t>(Music::loopCrossfadeSamples(sampleRate));
+    return fileSize == HEADER_SIZE + stored * sizeof(float) &&
+           std::memcmp(header, MAGIC, sizeof(MAGIC)) == 0 &&
+           std::memcmp(header + 16, &BYTE_ORDER_TAG, sizeof(float)) == 0 &&
+           getU32(header + 4) == MusicLoopCache::VERSION &&
+           getU32(header + 8) == static_cast<uint32_t>(sampleRate) &&
+           getU32(header + 12) == samples;
+}
+
+} // namespace
+
+MusicLoopCache::~MusicLoopCache() {
+    close();
+}
+
+bool MusicLoopCache::open(const std::string& path, int sampleRate) {
+    close();
+    if (map(path, sampleRate)) {
+        return true;
+    }
+    return build(path, sampleRate) && map(path, sampleRate);
+}
+
+void MusicLoopCache::close() {
+#ifndef _WIN32
+    if (mapping_) {
+        munmap(mapping_, mappingSize_);
+    }
+#endif
+    mapping_ = nullptr;
+    mappingSize_ = 0;
+    fallback_.clear();
+    samples_ = nullptr;
+}
+
+bool MusicLoopCache::build(const std::string& path, int sampleRate) {
+    const size_t loop = static_cast<size_t>(Music::loopSamples(sampleRate));
+    const int crossfade = Music::loopCrossfadeSamples(sampleRate);
+
+    // A fresh track, rendered one crossfade past the loop point
+    Music music;
+    music.setSampleRate(sampleRate);
+    music.setVolume(1.0f);
+    std::vector<float> rendered(loop + crossfade);
+    music.render(rendered.data(), static_cast<int>(rendered.size()));
+
+    // The opening for later passes: the tail fading into the start, so the
+    // end of the loop runs straight into what the track would have played
+    // next. The first pass keeps the untouched opening.
+    for (int i = 0; i < crossfade; i++) {
+        float fadeIn = static_cast<float>(i) / crossfade;
+        rendered[loop + i] = rendered[i] * fadeIn + rendered[loop + i] * (1.0f - fadeIn);
+    }
+
+    unsigned char header[HEADER_SIZE];
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    putU32(header + 4, VERSION);
+    putU32(header + 8, static_cast<uint32_t>(sampleRate));
+    putU32(header + 12, static_cast<uint32_t>(loop));
+    std::memcpy(header + 16, &BYTE_ORDER_TAG, sizeof(float));
+
+    // Written beside the target and renamed, so a reader never maps half a file
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+        file.write(reinterpret_cast<const char*>(rendered.data()), static_cast<std::streamsize>(rendered.size() * sizeof(float)));
+        if (!file) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+#ifndef _WIN32
+
+bool MusicLoopCache::map(const std::string& path, int sampleRate) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) > HEADER_SIZE) {
+        mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    if (!validHeader(static_cast<const unsigned char*>(mapping), size, sampleRate)) {
+        munmap(mapping, size);
+        return false;
+    }
+
+    // Lock the pages in, so playback can't fault on an evicted page. That
+    // fails beyond RLIMIT_MEMLOCK; then touching every page at least keeps
+    // first-touch faults off the audio thread, though the kernel may still
+    // evict pages under memory pressure.
+    mlock(mapping, size);
+    volatile unsigned char sink = 0;
+    const unsigned char* bytes = static_cast<const unsigned char*>(mapping);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    for (size_t offset = 0; offset < size; offset += static_cast<size_t>(pageSize)) {
+        sink = sink + bytes[offset];
+    }
+
+    mapping_ = mapping;
+    mappingSize_ = size;
+    samples_ = reinterpret_cast<const float*>(bytes + HEADER_SIZE);
+    return true;
+}
+
+#else
+
+bool MusicLoopCache::map(const std::string& path, int sampleRate) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(file.tellg());
+    unsigned char header[HEADER_SIZE];
+    file.seekg(0);
+    if (size <= HEADER_SIZE || !file.read(reinterpret_cast<char*>(header), HEADER_SIZE) ||
+        !validHeader(header, size, sampleRate)) {
+        return false;
+    }
+
+    fallback_.resize((size - HEADER_SIZE) / sizeof(float));
+    if (!file.read(reinterpret_cast<char*>(fallback_.data()), static_cast<std::streamsize>(size - HEADER_SIZE))) {
+        fallback_.clear();
+        return false;
+    }
+    samples_ = fallback_.data();
+    return true;
+}
+
+#endif
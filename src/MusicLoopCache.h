@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One pre-rendered loop of the music track, kept in a cache file and
+// memory mapped, so steady-state playback is a copy instead of synthesis.
+//
+// The loop is stored exactly as the live track plays it, followed by a
+// copy of its opening with the tail that would come after the loop
+// crossfaded in. Music plays that copy on every pass after the first,
+// which hides the parts of the track that are not exactly periodic (noise
+// and the pad LFO) at the loop point.
+//
+// File format: "TMUS", then little-endian uint32 version, sample rate and
+// loop length, then the float32 value 1.0 as a byte-order tag, then the
+// loop and Music::loopCrossfadeSamples() more float32 samples. Samples are
+// in the byte order of the machine that wrote them, so they can be mapped
+// and played as they are; a file whose tag doesn't read back as 1.0 is
+// rebuilt.
+class MusicLoopCache {
+public:
+    MusicLoopCache() = default;
+    ~MusicLoopCache();
+
+    MusicLoopCache(const MusicLoopCache&) = delete;
+    MusicLoopCache& operator=(const MusicLoopCache&) = delete;
+
+    // Maps the cache at path, rendering and writing it first if it is
+    // missing, was made by a different version of the synth or at another
+    // sample rate. Slow on a miss, so call it off the audio and game threads.
+    bool open(const std::string& path, int sampleRate);
+    void close();
+
+    // Renders the loop at sampleRate and writes it to path
+    static bool build(const std::string& path, int sampleRate);
+
+    // The loop and its crossfaded opening at volume 1, as Music::setLoop()
+    // takes them, or null until open succeeds
+    const float* samples() const { return samples_; }
+
+    static constexpr uint32_t VERSION = 1;      // Bump whenever Music's output or the layout changes
+
+private:
+    bool map(const std::string& path, int sampleRate);
+
+    const float* samples_ = nullptr;
+
+    void* mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+    std::vector<float> fallback_;   // Platforms without mmap read the file instead
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Board.h"
+#include "Tetromino.h"
+#include <cstdint>
+
+// Layout, colors and bitmap font shared by the SDL renderer and the
+// software framebuffer renderer, so both draw the same picture
+namespace render_style {
+
+inline constexpr int CELL_SIZE = 30;
+inline constexpr int PADDING = 20;
+inline constexpr int SIDEBAR_WIDTH = 150;
+
+inline constexpr int WINDOW_WIDTH = Board::WIDTH * CELL_SIZE + PADDING * 2 + SIDEBAR_WIDTH;
+inline constexpr int WINDOW_HEIGHT = Board::HEIGHT * CELL_SIZE + PADDING * 2;
+
+inline constexpr int BOARD_X = PADDING;
+inline constexpr int BOARD_Y = PADDING;
+inline constexpr int SIDEBAR_X = BOARD_X + Board::WIDTH * CELL_SIZE + PADDING;
+inline constexpr int NEXT_LABEL_Y = PADDING + 5;
+inline constexpr int PREVIEW_Y = PADDING + 30;
+inline constexpr int STATS_Y = PADDING + 160;
+inline constexpr int STATS_ROW_HEIGHT = 45;
+inline constexpr int STATS_VALUE_OFFSET = 18;
+
+inline constexpr Color WINDOW_COLOR = {20, 20, 20};
+inline constexpr Color BOARD_COLOR = {40, 40, 40};
+inline constexpr Color GRID_COLOR = {60, 60, 60};
+inline constexpr Color PREVIEW_BORDER_COLOR = {80, 80, 80};
+inline constexpr Color LABEL_COLOR = {150, 150, 150};
+inline constexpr Color TIME_COLOR = {255, 255, 255};
+inline constexpr Color SCORE_COLOR = {255, 255, 0};
+inline constexpr Color LEVEL_COLOR = {0, 255, 255};
+inline constexpr Color LINES_COLOR = {0, 255, 0};
+inline constexpr Color GAME_OVER_COLOR = {255, 0, 0};
+
+inline constexpr uint8_t GAME_OVER_ALPHA = 180;
+
+// Cell bevel: lighter top and left edges, darker bottom and right edges
+inline constexpr int BEVEL = 50;
+
+// 5x7 bitmap font for digits 0-9
+// Each digit is represented as 7 rows of 5 bits
+inline constexpr uint8_t DIGIT_FONT[10][7] = {
+    {0b01110, 0b10001, 0b10011, 0b10101, 0b11001, 0b10001, 0b01110}, // 0
+    {0b00100, 0b01100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110}, // 1
+    {0b01110, 0b10001, 0b00001, 0b00110, 0b01000, 0b10000, 0b11111}, // 2
+    {0b01110, 0b10001, 0b00001, 0b00110, 0b00001, 0b10001, 0b01110}, // 3
+    {0b00010, 0b00110, 0b01010, 0b10010, 0b11111, 0b00010, 0b00010}, // 4
+    {0b11111, 0b10000, 0b11110, 0b00001, 0b00001, 0b10001, 0b01110}, // 5
+    {0b00110, 0b01000, 0b10000, 0b11110, 0b10001, 0b10001, 0b01110}, // 6
+    {0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b01000, 0b01000}, // 7
+    {0b01110, 0b10001, 0b10001, 0b01110, 0b10001, 0b10001, 0b01110}, // 8
+    {0b01110, 0b10001, 0b10001, 0b01111, 0b00001, 0b00010, 0b01100}, // 9
+};
+
+// Simple 5x7 bitmap font for letters (uppercase only, subset)
+inline constexpr uint8_t LETTER_FONT[26][7] = {
+    {0b01110, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001}, // A
+    {0b11110, 0b10001, 0b10001, 0b11110, 0b10001, 0b10001, 0b11110}, // B
+    {0b01110, 0b10001, 0b10000, 0b10000, 0b10000, 0b10001, 0b01110}, // C
+    {0b11110, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b11110}, // D
+    {0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b11111}, // E
+    {0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b10000}, // F
+    {0b01110, 0b10001, 0b10000, 0b10111, 0b10001, 0b10001, 0b01111}, // G
+    {0b10001, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001}, // H
+    {0b01110, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110}, // I
+    {0b00111, 0b00010, 0b00010, 0b00010, 0b00010, 0b10010, 0b01100}, // J
+    {0b10001, 0b10010, 0b10100, 0b11000, 0b10100, 0b10010, 0b10001}, // K
+    {0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b11111}, // L
+    {0b10001, 0b11011, 0b10101, 0b10101, 0b10001, 0b10001, 0b10001}, // M
+    {0b10001, 0b10001, 0b11001, 0b10101, 0b10011, 0b10001, 0b10001}, // N
+    {0b01110, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110}, // O
+    {0b11110, 0b10001, 0b10001, 0b11110, 0b10000, 0b10000, 0b10000}, // P
+    {0b01110, 0b10001, 0b10001, 0b10001, 0b10101, 0b10010, 0b01101}, // Q
+    {0b11110, 0b10001, 0b10001, 0b11110, 0b10100, 0b10010, 0b10001}, // R
+    {0b01110, 0b10001, 0b10000, 0b01110, 0b00001, 0b10001, 0b01110}, // S
+    {0b11111, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100}, // T
+    {0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110}, // U
+    {0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01010, 0b00100}, // V
+    {0b10001, 0b10001, 0b10001, 0b10101, 0b10101, 0b10101, 0b01010}, // W
+    {0b10001, 0b10001, 0b01010, 0b00100, 0b01010, 0b10001, 0b10001}, // X
+    {0b10001, 0b10001, 0b01010, 0b00100, 0b00100, 0b00100, 0b00100}, // Y
+    {0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b11111}, // Z
+};
+
+// Decimal point for the performance HUD and colon for the clock
+inline constexpr uint8_t POINT_GLYPH[7] = {0, 0, 0, 0, 0, 0b01100, 0b01100};
+inline constexpr uint8_t COLON_GLYPH[7] = {0, 0, 0b10000, 0, 0, 0b10000, 0};
+
+// 5 columns, most significant of the low 5 bits on the left
+inline constexpr int GLYPH_WIDTH = 5;
+inline constexpr int GLYPH_HEIGHT = 7;
+
+// Rows of the glyph for c, or nullptr if the font has no such character
+inline const uint8_t* glyphFor(char c) {
+    if (c >= '0' && c <= '9') return DIGIT_FONT[c - '0'];
+    if (c >= 'A' && c <= 'Z') return LETTER_FONT[c - 'A'];
+    if (c >= 'a' && c <= 'z') return LETTER_FONT[c - 'a'];
+    if (c == '.') return POINT_GLYPH;
+    if (c == ':') return COLON_GLYPH;
+    return nullptr;
+}
+
+} // namespace render_style
@@ -1,69 +1,76 @@
 #include "Renderer.h"
+#include <algorithm>
 #include <iostream>
+#include <cstdio>
 #include <cstring>
 
-// 5x7 bitmap font for digits 0-9
-// Each digit is represented as 7 rows of 5 bits
-static const uint8_t DIGIT_FONT[10][7] = {
-    {0b01110, 0b10001, 0b10011, 0b10101, 0b11001, 0b10001, 0b01110}, // 0
-    {0b00100, 0b01100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110}, // 1
-    {0b01110, 0b10001, 0b00001, 0b00110, 0b01000, 0b10000, 0b11111}, // 2
-    {0b01110, 0b10001, 0b00001, 0b00110, 0b00001, 0b10001, 0b01110}, // 3
-    {0b00010, 0b00110, 0b01010, 0b10010, 0b11111, 0b00010, 0b00010}, // 4
-    {0b11111, 0b10000, 0b11110, 0b00001, 0b00001, 0b10001, 0b01110}, // 5
-    {0b00110, 0b01000, 0b10000, 0b11110, 0b10001, 0b10001, 0b01110}, // 6
-    {0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b01000, 0b01000}, // 7
-    {0b01110, 0b10001, 0b10001, 0b01110, 0b10001, 0b10001, 0b01110}, // 8
-    {0b01110, 0b10001, 0b10001, 0b01111, 0b00001, 0b00010, 0b01100}, // 9
-};
-
-// Simple 5x7 bitmap font for letters (uppercase only, subset)
-static const uint8_t LETTER_FONT[26][7] = {
-    {0b01110, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001}, // A
-    {0b11110, 0b10001, 0b10001, 0b11110, 0b10001, 0b10001, 0b11110}, // B
-    {0b01110, 0b10001, 0b10000, 0b10000, 0b10000, 0b10001, 0b01110}, // C
-    {0b11110, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b11110}, // D
-    {0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b11111}, // E
-    {0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b10000}, // F
-    {0b01110, 0b10001, 0b10000, 0b10111, 0b10001, 0b10001, 0b01111}, // G
-    {0b10001, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001}, // H
-    {0b01110, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110}, // I
-    {0b00111, 0b00010, 0b00010, 0b00010, 0b00010, 0b10010, 0b01100}, // J
-    {0b10001, 0b10010, 0b10100, 0b11000, 0b10100, 0b10010, 0b10001}, // K
-    {0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b11111}, // L
-    {0b10001, 0b11011, 0b10101, 0b10101, 0b10001, 0b10001, 0b10001}, // M
-    {0b10001, 0b10001, 0b11001, 0b10101, 0b10011, 0b10001, 0b10001}, // N
-    {0b01110, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110}, // O
-    {0b11110, 0b10001, 0b10001, 0b11110, 0b10000, 0b10000, 0b10000}, // P
-    {0b01110, 0b10001, 0b10001, 0b10001, 0b10101, 0b10010, 0b01101}, // Q
-    {0b11110, 0b10001, 0b10001, 0b11110, 0b10100, 0b10010, 0b10001}, // R
-    {0b01110, 0b10001, 0b10000, 0b01110, 0b00001, 0b10001, 0b01110}, // S
-    {0b11111, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100}, // T
-    {0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110}, // U
-    {0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01010, 0b00100}, // V
-    {0b10001, 0b10001, 0b10001, 0b10101, 0b10101, 0b10101, 0b01010}, // W
-    {0b10001, 0b10001, 0b01010, 0b00100, 0b01010, 0b10001, 0b10001}, // X
-    {0b10001, 0b10001, 0b01010, 0b00100, 0b00100, 0b00100, 0b00100}, // Y
-    {0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b11111}, // Z
-};
+// Texture atlas layout: one beveled sprite per piece type along the top,
+// then a row of every glyph for each text scale
+namespace {
+
+constexpr int CELL_SPRITE = Renderer::CELL_SIZE - 2;
+constexpr int TYPE_COUNT = static_cast<int>(TetrominoType::Count);
+
+constexpr int GLYPH_COUNT = 10 + 26 + 2; // Digits, letters, point, colon
+constexpr int MAX_TEXT_SCALE = 3;
+
+constexpr int glyphRowY(int scale) {
+    int y = CELL_SPRITE + 1;
+    for (int s = 1; s < scale; s++) {
+        y += 7 * s + 1;
+    }
+    return y;
+}
+
+constexpr int ATLAS_WIDTH = std::max(TYPE_COUNT * (CELL_SPRITE + 1), GLYPH_COUNT * (5 * MAX_TEXT_SCALE + 1));
+constexpr int ATLAS_HEIGHT = glyphRowY(MAX_TEXT_SCALE + 1);
+
+int glyphIndex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return 10 + (c - 'A');
+    if (c >= 'a' && c <= 'z') return 10 + (c - 'a');
+    if (c == '.') return 36;
+    if (c == ':') return 37;
+    return -1;
+}
+
+const uint8_t* glyphBits(int index) {
+    if (index < 10) return render_style::DIGIT_FONT[index];
+    if (index < 36) return render_style::LETTER_FONT[index - 10];
+    return index == 36 ? render_style::POINT_GLYPH : render_style::COLON_GLYPH;
+}
+
+SDL_Rect glyphRect(int index, int scale) {
+    return {index * (5 * scale + 1), glyphRowY(scale), 5 * scale, 7 * scale};
+}
+
+SDL_Rect cellRect(TetrominoType type) {
+    return {static_cast<int>(type) * (CELL_SPRITE + 1), 0, CELL_SPRITE, CELL_SPRITE};
+}
+
+uint32_t argb(int r, int g, int b) {
+    return 0xFF000000u | static_cast<uint32_t>(r) << 16 | static_cast<uint32_t>(g) << 8 | static_cast<uint32_t>(b);
+}
+
+} // namespace
 
 Renderer::Renderer() {
-    boardOffsetX_ = PADDING;
-    boardOffsetY_ = PADDING;
+    boardOffsetX_ = render_style::BOARD_X;
+    boardOffsetY_ = render_style::BOARD_Y;
 }
 
 Renderer::~Renderer() {
     shutdown();
 }
 
-bool Renderer::init() {
+bool Renderer::init(bool vsync) {
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "SDL_Init failed: " << SDL_GetError() << std::endl;
         return false;
     }
 
-    int windowWidth = Board::WIDTH * CELL_SIZE + PADDING * 2 + SIDEBAR_WIDTH;
-    int windowHeight = Board::HEIGHT * CELL_SIZE + PADDING * 2;
+    int windowWidth = render_style::WINDOW_WIDTH;
+    int windowHeight = render_style::WINDOW_HEIGHT;
 
     window_ = SDL_CreateWindow(
         "Tetris",
@@ -77,16 +84,92 @@ bool Renderer::init() {
         return false;
     }
 
-    renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_ACCELERATED);
+    Uint32 vsyncFlag = vsync ? SDL_RENDERER_PRESENTVSYNC : 0;
+    renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_ACCELERATED | vsyncFlag);
+    if (!renderer_) {
+        // No GPU (e.g. the dummy video driver): fall back to SDL's software renderer
+        renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_SOFTWARE | vsyncFlag);
+    }
     if (!renderer_) {
         std::cerr << "SDL_CreateRenderer failed: " << SDL_GetError() << std::endl;
         return false;
     }
 
+    // The driver may ignore the request, so check what we actually got
+    SDL_RendererInfo info;
+    vsync_ = SDL_GetRendererInfo(renderer_, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+
+    if (!createAtlas()) {
+        std::cerr << "Failed to create texture atlas: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
     return true;
 }
 
+bool Renderer::createAtlas() {
+    std::vector<uint32_t> pixels(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+
+    auto fill = [&](int x, int y, int w, int h, uint32_t color) {
+        for (int row = y; row < y + h; row++) {
+            std::fill_n(pixels.begin() + row * ATLAS_WIDTH + x, w, color);
+        }
+    };
+
+    // Beveled cells, edges in the order they used to be drawn so the shadow
+    // wins at the two corners it shares with the highlight
+    for (int t = 0; t < TYPE_COUNT; t++) {
+        Color color = Tetromino::getColorForType(static_cast<TetrominoType>(t));
+        constexpr int bevel = render_style::BEVEL;
+        uint32_t highlight = argb(std::min(255, color.r + bevel), std::min(255, color.g + bevel), std::min(255, color.b + bevel));
+        uint32_t shadow = argb(std::max(0, color.r - bevel), std::max(0, color.g - bevel), std::max(0, color.b - bevel));
+
+        SDL_Rect rect = cellRect(static_cast<TetrominoType>(t));
+        fill(rect.x, rect.y, rect.w, rect.h, argb(color.r, color.g, color.b));
+        fill(rect.x, rect.y, rect.w, 1, highlight);
+        fill(rect.x, rect.y, 1, rect.h, highlight);
+        fill(rect.x, rect.y + rect.h - 1, rect.w, 1, shadow);
+        fill(rect.x + rect.w - 1, rect.y, 1, rect.h, shadow);
+    }
+
+    // White glyphs, tinted per draw
+    for (int scale = 1; scale <= MAX_TEXT_SCALE; scale++) {
+        for (int index = 0; index < GLYPH_COUNT; index++) {
+            const uint8_t* bits = glyphBits(index);
+            SDL_Rect rect = glyphRect(index, scale);
+            for (int row = 0; row < 7; row++) {
+                for (int col = 0; col < 5; col++) {
+                    if (bits[row] & (1 << (4 - col))) {
+                        fill(rect.x + col * scale, rect.y + row * scale, scale, scale, 0xFFFFFFFFu);
+                    }
+                }
+            }
+        }
+    }
+
+    atlas_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, ATLAS_WIDTH, ATLAS_HEIGHT);
+    if (!atlas_) {
+        return false;
+    }
+    SDL_SetTextureBlendMode(atlas_, SDL_BLENDMODE_BLEND);
+    return SDL_UpdateTexture(atlas_, nullptr, pixels.data(), ATLAS_WIDTH * static_cast<int>(sizeof(uint32_t))) == 0;
+}
+
 void Renderer::shutdown() {
+    if (atlas_) {
+        SDL_DestroyTexture(atlas_);
+        atlas_ = nullptr;
+    }
+    if (background_) {
+        SDL_DestroyTexture(background_);
+        background_ = nullptr;
+        backgroundValid_ = false;
+    }
+    if (boardTexture_) {
+        SDL_DestroyTexture(boardTexture_);
+        boardTexture_ = nullptr;
+        boardTextureValid_ = false;
+    }
     if (renderer_) {
         SDL_DestroyRenderer(renderer_);
         renderer_ = nullptr;
@@ -99,11 +182,64 @@ void Renderer::shutdown() {
 }
 
 void Renderer::clear() {
-    SDL_SetRenderDrawColor(renderer_, 20, 20, 20, 255);
+    if (updateBackground()) {
+        SDL_RenderCopy(renderer_, background_, nullptr, nullptr);
+    } else {
+        // No render target support: paint the chrome every frame
+        paintBackground();
+    }
+}
+
+void Renderer::handleEvent(const SDL_Event& event) {
+    if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+        invalidateBackground();
+    }
+    // Target texture contents are lost when the device is reset
+    if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+        invalidateBackground();
+        boardTextureValid_ = false;
+    }
+}
+
+bool Renderer::updateBackground() {
+    if (backgroundValid_) {
+        return true;
+    }
+    if (!SDL_RenderTargetSupported(renderer_)) {
+        return false;
+    }
+
+    int width, height;
+    SDL_GetWindowSize(window_, &width, &height);
+
+    int textureWidth = 0, textureHeight = 0;
+    if (background_) {
+        SDL_QueryTexture(background_, nullptr, nullptr, &textureWidth, &textureHeight);
+    }
+    if (!background_ || textureWidth != width || textureHeight != height) {
+        if (background_) {
+            SDL_DestroyTexture(background_);
+        }
+        background_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (!background_) {
+            return false;
+        }
+    }
+
+    SDL_SetRenderTarget(renderer_, background_);
+    paintBackground();
+    SDL_SetRenderTarget(renderer_, nullptr);
+
+    backgroundValid_ = true;
+    return true;
+}
+
+void Renderer::paintBackground() {
+    setDrawColor(render_style::WINDOW_COLOR);
     SDL_RenderClear(renderer_);
 
     // Draw board background
-    SDL_SetRenderDrawColor(renderer_, 40, 40, 40, 255);
+    setDrawColor(render_style::BOARD_COLOR);
     SDL_Rect boardRect = {
         boardOffsetX_,
         boardOffsetY_,
@@ -113,7 +249,7 @@ void Renderer::clear() {
     SDL_RenderFillRect(renderer_, &boardRect);
 
     // Draw grid lines
-    SDL_SetRenderDrawColor(renderer_, 60, 60, 60, 255);
+    setDrawColor(render_style::GRID_COLOR);
     for (int x = 0; x <= Board::WIDTH; x++) {
         SDL_RenderDrawLine(
             renderer_,
@@ -128,59 +264,122 @@ void Renderer::clear() {
             boardOffsetX_ + Board::WIDTH * CELL_SIZE, boardOffsetY_ + y * CELL_SIZE
         );
     }
+
+    int sidebarX = render_style::SIDEBAR_X;
+
+    // Next piece preview box
+    drawLabel("NEXT", sidebarX, render_style::NEXT_LABEL_Y);
+
+    setDrawColor(render_style::BOARD_COLOR);
+    SDL_Rect previewRect = {sidebarX, render_style::PREVIEW_Y, 4 * CELL_SIZE, 4 * CELL_SIZE};
+    SDL_RenderFillRect(renderer_, &previewRect);
+
+    setDrawColor(render_style::PREVIEW_BORDER_COLOR);
+    SDL_RenderDrawRect(renderer_, &previewRect);
+
+    // Stat labels, the values are drawn per frame by drawStats
+    int startY = render_style::STATS_Y;
+    int rowHeight = render_style::STATS_ROW_HEIGHT;
+    drawLabel("TIME", sidebarX, startY);
+    drawLabel("SCORE", sidebarX, startY + rowHeight);
+    drawLabel("LEVEL", sidebarX, startY + rowHeight * 2);
+    drawLabel("LINES", sidebarX, startY + rowHeight * 3);
+
+    // The labels are batched, so finish them before the target changes
+    flushSprites();
 }
 
 void Renderer::present() {
+    flushSprites();
     SDL_RenderPresent(renderer_);
 }
 
-void Renderer::drawCell(int x, int y, Color color, int offsetX, int offsetY) {
+void Renderer::drawCell(int x, int y, TetrominoType type, int offsetX, int offsetY) {
     SDL_Rect rect = {
         offsetX + x * CELL_SIZE + 1,
         offsetY + y * CELL_SIZE + 1,
-        CELL_SIZE - 2,
-        CELL_SIZE - 2
+        CELL_SPRITE,
+        CELL_SPRITE
     };
+    drawSprite(cellRect(type), rect, {255, 255, 255, 255});
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+
+void Renderer::drawSprite(const SDL_Rect& source, const SDL_Rect& dest, SDL_Color color) {
+    int base = static_cast<int>(spriteVertices_.size());
+    float left = static_cast<float>(dest.x);
+    float top = static_cast<float>(dest.y);
+    float right = static_cast<float>(dest.x + dest.w);
+    float bottom = static_cast<float>(dest.y + dest.h);
+
+    float u0 = static_cast<float>(source.x) / ATLAS_WIDTH;
+    float v0 = static_cast<float>(source.y) / ATLAS_HEIGHT;
+    float u1 = static_cast<float>(source.x + source.w) / ATLAS_WIDTH;
+    float v1 = static_cast<float>(source.y + source.h) / ATLAS_HEIGHT;
+
+    spriteVertices_.push_back({{left, top}, color, {u0, v0}});
+    spriteVertices_.push_back({{right, top}, color, {u1, v0}});
+    spriteVertices_.push_back({{right, bottom}, color, {u1, v1}});
+    spriteVertices_.push_back({{left, bottom}, color, {u0, v1}});
+
+    const int quad[] = {0, 1, 2, 0, 2, 3};
+    for (int index : quad) {
+        spriteIndices_.push_back(base + index);
+    }
+}
+
+void Renderer::flushSprites() {
+    if (spriteIndices_.empty()) {
+        return;
+    }
+
+    SDL_RenderGeometry(renderer_, atlas_,
+                       spriteVertices_.data(), static_cast<int>(spriteVertices_.size()),
+                       spriteIndices_.data(), static_cast<int>(spriteIndices_.size()));
+    spriteVertices_.clear();
+    spriteIndices_.clear();
+}
+
+#else
+
+// SDL before 2.0.18 has no SDL_RenderGeometry, so sprites are copied one by one
+void Renderer::drawSprite(const SDL_Rect& source, const SDL_Rect& dest, SDL_Color color) {
+    SDL_SetTextureColorMod(atlas_, color.r, color.g, color.b);
+    SDL_RenderCopy(renderer_, atlas_, &source, &dest);
+}
 
-    // Draw filled cell
+void Renderer::flushSprites() {}
+
+#endif
+
+void Renderer::drawChar(char c, int x, int y, int scale) {
+    int index = glyphIndex(c);
+    if (index < 0 || scale < 1 || scale > MAX_TEXT_SCALE) return;
+
+    SDL_Rect source = glyphRect(index, scale);
+    SDL_Rect dest = {x, y, source.w, source.h};
+    drawSprite(source, dest, textColor_);
+}
+
+void Renderer::drawText(const char* text, int x, int y, int scale) {
+    int charWidth = 6 * scale;
+    for (int i = 0; text[i] != '\0'; i++) {
+        drawChar(text[i], x + i * charWidth, y, scale);
+    }
+}
+
+void Renderer::setTextColor(const Color& color) {
+    textColor_ = {color.r, color.g, color.b, 255};
+}
+
+void Renderer::setDrawColor(const Color& color) {
     SDL_SetRenderDrawColor(renderer_, color.r, color.g, color.b, 255);
-    SDL_RenderFillRect(renderer_, &rect);
-
-    // Draw highlight (top and left edges)
-    SDL_SetRenderDrawColor(renderer_,
-        std::min(255, color.r + 50),
-        std::min(255, color.g + 50),
-        std::min(255, color.b + 50),
-        255);
-    SDL_RenderDrawLine(renderer_, rect.x, rect.y, rect.x + rect.w - 1, rect.y);
-    SDL_RenderDrawLine(renderer_, rect.x, rect.y, rect.x, rect.y + rect.h - 1);
-
-    // Draw shadow (bottom and right edges)
-    SDL_SetRenderDrawColor(renderer_,
-        std::max(0, color.r - 50),
-        std::max(0, color.g - 50),
-        std::max(0, color.b - 50),
-        255);
-    SDL_RenderDrawLine(renderer_, rect.x, rect.y + rect.h - 1, rect.x + rect.w - 1, rect.y + rect.h - 1);
-    SDL_RenderDrawLine(renderer_, rect.x + rect.w - 1, rect.y, rect.x + rect.w - 1, rect.y + rect.h - 1);
 }
 
 void Renderer::drawDigit(int digit, int x, int y, int scale) {
     if (digit < 0 || digit > 9) return;
-
-    for (int row = 0; row < 7; row++) {
-        for (int col = 0; col < 5; col++) {
-            if (DIGIT_FONT[digit][row] & (1 << (4 - col))) {
-                SDL_Rect pixel = {
-                    x + col * scale,
-                    y + row * scale,
-                    scale,
-                    scale
-                };
-                SDL_RenderFillRect(renderer_, &pixel);
-            }
-        }
-    }
+    drawChar(static_cast<char>('0' + digit), x, y, scale);
 }
 
 void Renderer::drawNumber(int number, int x, int y, int scale, int minDigits) {
@@ -226,45 +425,8 @@ void Renderer::drawNumber(int number, int x, int y, int scale, int minDigits) {
 }
 
 void Renderer::drawLabel(const char* label, int x, int y) {
-    int scale = 2;
-    int charWidth = 6 * scale;
-
-    SDL_SetRenderDrawColor(renderer_, 150, 150, 150, 255);
-
-    for (int i = 0; label[i] != '\0'; i++) {
-        char c = label[i];
-        if (c >= 'A' && c <= 'Z') {
-            int idx = c - 'A';
-            for (int row = 0; row < 7; row++) {
-                for (int col = 0; col < 5; col++) {
-                    if (LETTER_FONT[idx][row] & (1 << (4 - col))) {
-                        SDL_Rect pixel = {
-                            x + i * charWidth + col * scale,
-                            y + row * scale,
-                            scale,
-                            scale
-                        };
-                        SDL_RenderFillRect(renderer_, &pixel);
-                    }
-                }
-            }
-        } else if (c >= 'a' && c <= 'z') {
-            int idx = c - 'a';
-            for (int row = 0; row < 7; row++) {
-                for (int col = 0; col < 5; col++) {
-                    if (LETTER_FONT[idx][row] & (1 << (4 - col))) {
-                        SDL_Rect pixel = {
-                            x + i * charWidth + col * scale,
-                            y + row * scale,
-                            scale,
-                            scale
-                        };
-                        SDL_RenderFillRect(renderer_, &pixel);
-                    }
-                }
-            }
-        }
-    }
+    setTextColor(render_style::LABEL_COLOR);
+    drawText(label, x, y, 2);
 }
 
 void Renderer::drawTime(int totalSeconds, int x, int y) {
@@ -274,45 +436,102 @@ void Renderer::drawTime(int totalSeconds, int x, int y) {
     int scale = 2;
     int digitWidth = 6 * scale;
 
-    SDL_SetRenderDrawColor(renderer_, 255, 255, 255, 255);
+    setTextColor(render_style::TIME_COLOR);
 
     // Draw minutes (at least 2 digits)
     drawNumber(minutes, x, y, scale, 2);
 
     // Draw colon
-    int colonX = x + 2 * digitWidth + 2;
-    SDL_Rect dot1 = {colonX, y + 2 * scale, scale, scale};
-    SDL_Rect dot2 = {colonX, y + 5 * scale, scale, scale};
-    SDL_RenderFillRect(renderer_, &dot1);
-    SDL_RenderFillRect(renderer_, &dot2);
+    drawChar(':', x + 2 * digitWidth + 2, y, scale);
 
     // Draw seconds (always 2 digits)
     drawNumber(seconds, x + 2 * digitWidth + scale + 4, y, scale, 2);
 }
 
 void Renderer::drawBoard(const Board& board) {
+    if (updateBoardTexture(board)) {
+        // One extra pixel for the closing grid lines
+        SDL_Rect dest = {boardOffsetX_, boardOffsetY_, Board::WIDTH * CELL_SIZE + 1, Board::HEIGHT * CELL_SIZE + 1};
+        SDL_RenderCopy(renderer_, boardTexture_, nullptr, &dest);
+        return;
+    }
+
+    // No render target support: draw every locked cell over the background
     for (int y = 0; y < Board::HEIGHT; y++) {
         for (int x = 0; x < Board::WIDTH; x++) {
             auto cell = board.getCell(x, y);
             if (cell.has_value()) {
-                Color color = Tetromino::getColorForType(cell.value());
-                drawCell(x, y, color, boardOffsetX_, boardOffsetY_);
+                drawCell(x, y, cell.value(), boardOffsetX_, boardOffsetY_);
             }
         }
     }
 }
 
-void Renderer::drawPiece(const Tetromino& piece) {
-    const auto& shape = piece.getShape();
-    Color color = piece.getColor();
+bool Renderer::updateBoardTexture(const Board& board) {
+    if (boardTextureValid_ && !board.hasDirtyRows()) {
+        return true;
+    }
+    if (!SDL_RenderTargetSupported(renderer_)) {
+        return false;
+    }
+
+    if (!boardTexture_) {
+        boardTexture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                          Board::WIDTH * CELL_SIZE + 1, Board::HEIGHT * CELL_SIZE + 1);
+        if (!boardTexture_) {
+            return false;
+        }
+    }
+
+    // Sprites queued for the window must land before the target changes
+    flushSprites();
+    SDL_SetRenderTarget(renderer_, boardTexture_);
+    if (boardTextureValid_) {
+        paintBoardRows(board, board.dirtyTop(), board.dirtyBottom());
+    } else {
+        paintBoardRows(board, 0, Board::HEIGHT);
+    }
+    flushSprites();
+    SDL_SetRenderTarget(renderer_, nullptr);
+
+    boardTextureValid_ = true;
+    return true;
+}
+
+void Renderer::paintBoardRows(const Board& board, int top, int bottom) {
+    int width = Board::WIDTH * CELL_SIZE;
 
+    // Covers the grid line under the last row too, it is redrawn below
+    setDrawColor(render_style::BOARD_COLOR);
+    SDL_Rect rowsRect = {0, top * CELL_SIZE, width, (bottom - top) * CELL_SIZE + 1};
+    SDL_RenderFillRect(renderer_, &rowsRect);
+
+    setDrawColor(render_style::GRID_COLOR);
+    for (int x = 0; x <= Board::WIDTH; x++) {
+        SDL_RenderDrawLine(renderer_, x * CELL_SIZE, top * CELL_SIZE, x * CELL_SIZE, bottom * CELL_SIZE);
+    }
+    for (int y = top; y <= bottom; y++) {
+        SDL_RenderDrawLine(renderer_, 0, y * CELL_SIZE, width, y * CELL_SIZE);
+    }
+
+    for (int y = top; y < bottom; y++) {
+        for (int x = 0; x < Board::WIDTH; x++) {
+            auto cell = board.getCell(x, y);
+            if (cell.has_value()) {
+                drawCell(x, y, cell.value());
+            }
+        }
+    }
+}
+
+void Renderer::drawPiece(const Tetromino& piece, int offsetY) {
     for (int y = 0; y < Tetromino::SIZE; y++) {
         for (int x = 0; x < Tetromino::SIZE; x++) {
-            if (shape[y][x]) {
+            if (piece.isFilled(x, y)) {
                 int boardX = piece.getX() + x;
                 int boardY = piece.getY() + y;
                 if (boardY >= 0) {
-                    drawCell(boardX, boardY, color, boardOffsetX_, boardOffsetY_);
+                    drawCell(boardX, boardY, piece.getType(), boardOffsetX_, boardOffsetY_ + offsetY);
                 }
             }
         }
@@ -320,64 +539,49 @@ void Renderer::drawPiece(const Tetromino& piece) {
 }
 
 void Renderer::drawNextPiece(const Tetromino& piece) {
-    int sidebarX = boardOffsetX_ + Board::WIDTH * CELL_SIZE + PADDING;
-    int nextPieceY = PADDING + 30;
-
-    // Draw "NEXT" label
-    drawLabel("NEXT", sidebarX, PADDING + 5);
-
-    // Draw next piece preview box
-    SDL_SetRenderDrawColor(renderer_, 40, 40, 40, 255);
-    SDL_Rect previewRect = {sidebarX, nextPieceY, 4 * CELL_SIZE, 4 * CELL_SIZE};
-    SDL_RenderFillRect(renderer_, &previewRect);
-
-    // Draw border
-    SDL_SetRenderDrawColor(renderer_, 80, 80, 80, 255);
-    SDL_RenderDrawRect(renderer_, &previewRect);
-
-    // Draw the next piece
-    const auto& shape = piece.getShape();
-    Color color = piece.getColor();
+    int sidebarX = render_style::SIDEBAR_X;
+    int nextPieceY = render_style::PREVIEW_Y;
 
+    // Only the piece itself, the label and box are in the cached background
     for (int y = 0; y < Tetromino::SIZE; y++) {
         for (int x = 0; x < Tetromino::SIZE; x++) {
-            if (shape[y][x]) {
-                drawCell(x, y, color, sidebarX, nextPieceY);
+            if (piece.isFilled(x, y)) {
+                drawCell(x, y, piece.getType(), sidebarX, nextPieceY);
             }
         }
     }
 }
 
 void Renderer::drawStats(int score, int level, int lines, int timeSeconds) {
-    int sidebarX = boardOffsetX_ + Board::WIDTH * CELL_SIZE + PADDING;
-    int startY = PADDING + 160;
-    int rowHeight = 45;
+    int sidebarX = render_style::SIDEBAR_X;
+    int startY = render_style::STATS_Y + render_style::STATS_VALUE_OFFSET;
+    int rowHeight = render_style::STATS_ROW_HEIGHT;
     int scale = 2;
 
+    // Only the values, the labels are in the cached background
+
     // TIME
-    drawLabel("TIME", sidebarX, startY);
-    drawTime(timeSeconds, sidebarX, startY + 18);
+    drawTime(timeSeconds, sidebarX, startY);
 
     // SCORE
-    drawLabel("SCORE", sidebarX, startY + rowHeight);
-    SDL_SetRenderDrawColor(renderer_, 255, 255, 0, 255); // Yellow for score
-    drawNumber(score, sidebarX, startY + rowHeight + 18, scale, 1);
+    setTextColor(render_style::SCORE_COLOR);
+    drawNumber(score, sidebarX, startY + rowHeight, scale, 1);
 
     // LEVEL
-    drawLabel("LEVEL", sidebarX, startY + rowHeight * 2);
-    SDL_SetRenderDrawColor(renderer_, 0, 255, 255, 255); // Cyan for level
-    drawNumber(level, sidebarX, startY + rowHeight * 2 + 18, scale, 1);
+    setTextColor(render_style::LEVEL_COLOR);
+    drawNumber(level, sidebarX, startY + rowHeight * 2, scale, 1);
 
     // LINES
-    drawLabel("LINES", sidebarX, startY + rowHeight * 3);
-    SDL_SetRenderDrawColor(renderer_, 0, 255, 0, 255); // Green for lines
-    drawNumber(lines, sidebarX, startY + rowHeight * 3 + 18, scale, 1);
+    setTextColor(render_style::LINES_COLOR);
+    drawNumber(lines, sidebarX, startY + rowHeight * 3, scale, 1);
 }
 
 void Renderer::drawGameOver() {
+    flushSprites();
+
     // Draw semi-transparent overlay
     SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_BLEND);
-    SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 180);
+    SDL_SetRenderDrawColor(renderer_, 0, 0, 0, render_style::GAME_OVER_ALPHA);
 
     SDL_Rect overlay = {
         boardOffsetX_,
@@ -391,54 +595,83 @@ void Renderer::drawGameOver() {
     int centerX = boardOffsetX_ + (Board::WIDTH * CELL_SIZE) / 2;
     int centerY = boardOffsetY_ + (Board::HEIGHT * CELL_SIZE) / 2;
 
-    SDL_SetRenderDrawColor(renderer_, 255, 0, 0, 255);
+    setTextColor(render_style::GAME_OVER_COLOR);
 
-    // "GAME" - 4 letters, each 12 pixels wide (scale 2)
+    // "GAME" and "OVER" - 4 letters each, 18 pixels wide (scale 3)
     int scale = 3;
     int charWidth = 6 * scale;
-    int gameWidth = 4 * charWidth;
-    int overWidth = 4 * charWidth;
-
-    int gameX = centerX - gameWidth / 2;
-    int overX = centerX - overWidth / 2;
-
-    // Draw GAME
-    const char* game = "GAME";
-    for (int i = 0; game[i] != '\0'; i++) {
-        int idx = game[i] - 'A';
-        for (int row = 0; row < 7; row++) {
-            for (int col = 0; col < 5; col++) {
-                if (LETTER_FONT[idx][row] & (1 << (4 - col))) {
-                    SDL_Rect pixel = {
-                        gameX + i * charWidth + col * scale,
-                        centerY - 30 + row * scale,
-                        scale,
-                        scale
-                    };
-                    SDL_RenderFillRect(renderer_, &pixel);
-                }
-            }
+    int wordWidth = 4 * charWidth;
+
+    drawText("GAME", centerX - wordWidth / 2, centerY - 30, scale);
+    drawText("OVER", centerX - wordWidth / 2, centerY + 5, scale);
+
+    SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_NONE);
+}
+
+void Renderer::drawPerfHud(const FrameStats& stats, const AudioStats::Snapshot& audio) {
+    flushSprites();
+
+    constexpr int scale = 1;
+    constexpr int lineHeight = 10;
+    constexpr int labelWidth = 8 * 6 * scale;
+    constexpr int columnWidth = 7 * 6 * scale;
+    constexpr int rows = static_cast<int>(FrameMetric::Count) + 4; // Header and three audio rows
+
+    int x = boardOffsetX_ + 4;
+    int y = boardOffsetY_ + 4;
+
+    SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 200);
+    SDL_Rect background = {x - 3, y - 3, labelWidth + columnWidth * 3 + 3, rows * lineHeight + 3};
+    SDL_RenderFillRect(renderer_, &background);
+    SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_NONE);
+
+    setTextColor(render_style::LABEL_COLOR);
+    drawText("MS", x, y, scale);
+    drawText("P50", x + labelWidth, y, scale);
+    drawText("P99", x + labelWidth + columnWidth, y, scale);
+    drawText("MAX", x + labelWidth + columnWidth * 2, y, scale);
+
+    for (int i = 0; i < static_cast<int>(FrameMetric::Count); i++) {
+        FrameMetric metric = static_cast<FrameMetric>(i);
+        FrameStats::Summary summary = stats.summary(metric);
+        int rowY = y + (i + 1) * lineHeight;
+
+        setTextColor(render_style::LABEL_COLOR);
+        drawText(FrameStats::metricName(metric), x, rowY, scale);
+        if (summary.samples == 0) {
+            continue;
         }
-    }
 
-    // Draw OVER
-    const char* over = "OVER";
-    for (int i = 0; over[i] != '\0'; i++) {
-        int idx = over[i] - 'A';
-        for (int row = 0; row < 7; row++) {
-            for (int col = 0; col < 5; col++) {
-                if (LETTER_FONT[idx][row] & (1 << (4 - col))) {
-                    SDL_Rect pixel = {
-                        overX + i * charWidth + col * scale,
-                        centerY + 5 + row * scale,
-                        scale,
-                        scale
-                    };
-                    SDL_RenderFillRect(renderer_, &pixel);
-                }
-            }
+        setTextColor(render_style::TIME_COLOR);
+        const double values[] = {summary.p50, summary.p99, summary.max};
+        for (int column = 0; column < 3; column++) {
+            char text[16];
+            std::snprintf(text, sizeof(text), "%.1f", values[column]);
+            drawText(text, x + labelWidth + columnWidth * column, rowY, scale);
         }
     }
 
-    SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_NONE);
+    // Audio callback durations since start, then the problem counters
+    int audioY = y + (static_cast<int>(FrameMetric::Count) + 1) * lineHeight;
+    setTextColor(render_style::LABEL_COLOR);
+    drawText("AUDIO", x, audioY, scale);
+    drawText("MISSED", x, audioY + lineHeight, scale);
+    drawText("XRUNS", x, audioY + lineHeight * 2, scale);
+    if (audio.callbacks == 0) {
+        return;
+    }
+
+    setTextColor(render_style::TIME_COLOR);
+    const double values[] = {audio.percentileMs(0.50), audio.percentileMs(0.99), audio.maxMs};
+    for (int column = 0; column < 3; column++) {
+        char text[16];
+        std::snprintf(text, sizeof(text), "%.2f", values[column]);
+        drawText(text, x + labelWidth + columnWidth * column, audioY, scale);
+    }
+    char text[24];
+    std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(audio.deadlineMisses));
+    drawText(text, x + labelWidth, audioY + lineHeight, scale);
+    std::snprintf(text, sizeof(text), "%llu", static_cast<unsigned long long>(audio.underruns));
+    drawText(text, x + labelWidth, audioY + lineHeight * 2, scale);
 }
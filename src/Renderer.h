@@ -1,41 +1,102 @@
 #pragma once
 
+#include "AudioStats.h"
 #include "Board.h"
+#include "FrameStats.h"
+#include "RenderStyle.h"
 #include "Tetromino.h"
 #include <SDL.h>
 #include <string>
+#include <vector>
 
 class Renderer {
 public:
-    static constexpr int CELL_SIZE = 30;
-    static constexpr int PADDING = 20;
-    static constexpr int SIDEBAR_WIDTH = 150;
+    static constexpr int CELL_SIZE = render_style::CELL_SIZE;
+    static constexpr int PADDING = render_style::PADDING;
+    static constexpr int SIDEBAR_WIDTH = render_style::SIDEBAR_WIDTH;
 
     Renderer();
     ~Renderer();
 
-    bool init();
+    // vsync paces present() to the display refresh where the driver allows it
+    bool init(bool vsync = false);
     void shutdown();
 
     void clear();
     void present();
 
+    bool hasVsync() const { return vsync_; }
+
+    // Rebuilds the cached background if the window or render targets changed
+    void handleEvent(const SDL_Event& event);
+
+    // Forces the static background to be repainted on the next clear()
+    void invalidateBackground() { backgroundValid_ = false; }
+
+    // Only the board's dirty rows are repainted into the cached board, so the
+    // caller clears them once drawn (Simulation::clearDirtyRows)
     void drawBoard(const Board& board);
-    void drawPiece(const Tetromino& piece);
+    // offsetY shifts the piece down by that many pixels, for smooth falling
+    void drawPiece(const Tetromino& piece, int offsetY = 0);
     void drawNextPiece(const Tetromino& piece);
     void drawStats(int score, int level, int lines, int timeSeconds);
     void drawGameOver();
 
+    // Overlay of rolling frame timings and audio callback timings in
+    // milliseconds, with audio deadline misses and underruns
+    void drawPerfHud(const FrameStats& stats, const AudioStats::Snapshot& audio);
+
 private:
-    void drawCell(int x, int y, Color color, int offsetX = 0, int offsetY = 0);
+    // Window fill, playfield, grid, preview box and sidebar labels
+    void paintBackground();
+    bool updateBackground();
+
+    // Playfield fill, grid lines and locked cells for rows [top, bottom),
+    // in board texture coordinates
+    void paintBoardRows(const Board& board, int top, int bottom);
+    bool updateBoardTexture(const Board& board);
+
+    bool createAtlas();
+
+    // Cells and text are copied from the atlas. Copies are queued and drawn
+    // together by flushSprites(), which runs before anything that may
+    // overlap them and before present().
+    void drawSprite(const SDL_Rect& source, const SDL_Rect& dest, SDL_Color color);
+    void flushSprites();
+
+    void drawCell(int x, int y, TetrominoType type, int offsetX = 0, int offsetY = 0);
     void drawDigit(int digit, int x, int y, int scale = 2);
     void drawNumber(int number, int x, int y, int scale = 2, int minDigits = 1);
     void drawLabel(const char* label, int x, int y);
     void drawTime(int totalSeconds, int x, int y);
+    void drawChar(char c, int x, int y, int scale);
+    void drawText(const char* text, int x, int y, int scale);
+    void setTextColor(const Color& color);
+    void setDrawColor(const Color& color);
 
     SDL_Window* window_ = nullptr;
     SDL_Renderer* renderer_ = nullptr;
 
     int boardOffsetX_;
     int boardOffsetY_;
+
+    bool vsync_ = false;
+
+    // Beveled cell sprites per piece type and white glyphs at each text scale
+    SDL_Texture* atlas_ = nullptr;
+    SDL_Color textColor_ = {255, 255, 255, 255};
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    // Every queued sprite as one triangle list, reused across frames
+    std::vector<SDL_Vertex> spriteVertices_;
+    std::vector<int> spriteIndices_;
+#endif
+
+    // The static chrome, painted once into a render target and copied each frame
+    SDL_Texture* background_ = nullptr;
+    bool backgroundValid_ = false;
+
+    // The locked cells, patched row by row as the board changes
+    SDL_Texture* boardTexture_ = nullptr;
+    bool boardTextureValid_ = false;
 };
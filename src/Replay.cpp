@@ -0,0 +1,144 @@
+#include "Replay.h"
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+constexpr char MAGIC[4] = {'T', 'R', 'P', 'L'};
+constexpr int INPUT_BITS = 3;
+
+void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool readVarint(const std::vector<uint8_t>& data, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= data.size()) return false;
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+void Replay::record(uint64_t timeMs, Input input) {
+    entries_.push_back({timeMs, input});
+}
+
+void Replay::finish(const Simulation& simulation) {
+    outcome_.score = simulation.score();
+    outcome_.lines = simulation.totalLines();
+    outcome_.pieces = simulation.piecesPlaced();
+    outcome_.endTimeMs = simulation.elapsedMs();
+}
+
+std::vector<uint8_t> Replay::encode() const {
+    std::vector<uint8_t> out(std::begin(MAGIC), std::end(MAGIC));
+    out.push_back(VERSION);
+
+    writeVarint(out, seed_);
+    writeVarint(out, entries_.size());
+
+    uint64_t lastTime = 0;
+    for (const Entry& entry : entries_) {
+        writeVarint(out, ((entry.timeMs - lastTime) << INPUT_BITS) | static_cast<uint64_t>(entry.input));
+        lastTime = entry.timeMs;
+    }
+
+    writeVarint(out, outcome_.endTimeMs - lastTime);
+    writeVarint(out, static_cast<uint64_t>(outcome_.score));
+    writeVarint(out, static_cast<uint64_t>(outcome_.lines));
+    writeVarint(out, static_cast<uint64_t>(outcome_.pieces));
+
+    return out;
+}
+
+bool Replay::decode(const std::vector<uint8_t>& data, Replay& replay) {
+    if (data.size() < sizeof(MAGIC) + 1 || !std::equal(std::begin(MAGIC), std::end(MAGIC), data.begin())) {
+        return false;
+    }
+    if (data[sizeof(MAGIC)] != VERSION) {
+        return false;
+    }
+
+    size_t pos = sizeof(MAGIC) + 1;
+    uint64_t seed, count;
+    if (!readVarint(data, pos, seed) || !readVarint(data, pos, count)) {
+        return false;
+    }
+    // Every entry takes at least one byte
+    if (count > data.size() - pos) {
+        return false;
+    }
+
+    Replay result(static_cast<uint32_t>(seed));
+    result.entries_.reserve(count);
+
+    uint64_t time = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t packed;
+        if (!readVarint(data, pos, packed)) return false;
+
+        uint64_t input = packed & ((1u << INPUT_BITS) - 1);
+        if (input > static_cast<uint64_t>(Input::Restart)) return false;
+
+        time += packed >> INPUT_BITS;
+        result.entries_.push_back({time, static_cast<Input>(input)});
+    }
+
+    uint64_t endDelta, score, lines, pieces;
+    if (!readVarint(data, pos, endDelta) || !readVarint(data, pos, score) ||
+        !readVarint(data, pos, lines) || !readVarint(data, pos, pieces)) {
+        return false;
+    }
+    result.outcome_.endTimeMs = time + endDelta;
+    result.outcome_.score = static_cast<int>(score);
+    result.outcome_.lines = static_cast<int>(lines);
+    result.outcome_.pieces = static_cast<int>(pieces);
+
+    // Trailing bytes reject the file, leaving replay untouched
+    if (pos != data.size()) {
+        return false;
+    }
+    replay = std::move(result);
+    return true;
+}
+
+bool Replay::save(const std::string& path) const {
+    std::vector<uint8_t> data = encode();
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+bool Replay::load(const std::string& path, Replay& replay) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return decode(data, replay);
+}
+
+ReplayOutcome Replay::simulate() const {
+    Simulation simulation(seed_);
+
+    for (const Entry& entry : entries_) {
+        simulation.step(Input::None, static_cast<uint32_t>(entry.timeMs - simulation.elapsedMs()));
+        simulation.step(entry.input, 0);
+    }
+    simulation.step(Input::None, static_cast<uint32_t>(outcome_.endTimeMs - simulation.elapsedMs()));
+
+    ReplayOutcome outcome;
+    outcome.score = simulation.score();
+    outcome.lines = simulation.totalLines();
+    outcome.pieces = simulation.piecesPlaced();
+    outcome.endTimeMs = simulation.elapsedMs();
+    return outcome;
+}
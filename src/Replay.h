@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Simulation.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Final state of a game, stored with a replay and compared on verification
+struct ReplayOutcome {
+    int score = 0;
+    int lines = 0;
+    int pieces = 0;
+    uint64_t endTimeMs = 0;
+
+    bool operator==(const ReplayOutcome& other) const {
+        return score == other.score && lines == other.lines &&
+               pieces == other.pieces && endTimeMs == other.endTimeMs;
+    }
+    bool operator!=(const ReplayOutcome& other) const { return !(*this == other); }
+};
+
+// Everything needed to reproduce one game: the seed and every input with
+// the simulation time it was applied at. Since Simulation is deterministic
+// and gravity doesn't depend on how time is sliced into steps, that is
+// enough to rebuild the game exactly.
+//
+// Binary format (all integers are LEB128 varints):
+//   "TRPL" version seed inputCount
+//   inputCount x ((timeDelta << 3) | input)
+//   endTimeDelta score lines pieces
+class Replay {
+public:
+    struct Entry {
+        uint64_t timeMs;
+        Input input;
+    };
+
+    explicit Replay(uint32_t seed = 0) : seed_(seed) {}
+
+    void record(uint64_t timeMs, Input input);
+
+    // Stores the outcome to check against when the game ends or is abandoned
+    void finish(const Simulation& simulation);
+
+    uint32_t seed() const { return seed_; }
+    const std::vector<Entry>& entries() const { return entries_; }
+    const ReplayOutcome& outcome() const { return outcome_; }
+
+    std::vector<uint8_t> encode() const;
+    static bool decode(const std::vector<uint8_t>& data, Replay& replay);
+
+    bool save(const std::string& path) const;
+    static bool load(const std::string& path, Replay& replay);
+
+    // Re-simulates the game as fast as possible and returns its outcome
+    ReplayOutcome simulate() const;
+
+    bool verify() const { return simulate() == outcome_; }
+
+    static constexpr uint8_t VERSION = 1;
+
+private:
+    uint32_t seed_;
+    std::vector<Entry> entries_;
+    ReplayOutcome outcome_;
+};
@@ -0,0 +1,105 @@
+#include "Resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TETRIS_RESAMPLER_SSE2 1
+#endif
+
+namespace {
+
+// Passband edge as a fraction of the narrower Nyquist frequency
+constexpr double CUTOFF = 0.85;
+
+// The SSE2 and scalar versions sum in the same order, so they produce
+// identical output. taps is a multiple of 4.
+float dot(const float* a, const float* b, int taps) {
+#if TETRIS_RESAMPLER_SSE2
+    __m128 sum = _mm_setzero_ps();
+    for (int i = 0; i < taps; i += 4) {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#else
+    float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < taps; i += 4) {
+        for (int lane = 0; lane < 4; lane++) {
+            sum[lane] += a[i + lane] * b[i + lane];
+        }
+    }
+    return (sum[0] + sum[2]) + (sum[1] + sum[3]);
+#endif
+}
+
+} // namespace
+
+bool Resampler::configure(int inputRate, int outputRate) {
+    int divisor = std::gcd(inputRate, outputRate);
+    if (divisor <= 0 || outputRate / divisor > MAX_PHASES) {
+        return false;
+    }
+    upFactor_ = outputRate / divisor;
+    downFactor_ = inputRate / divisor;
+
+    int decimation = (downFactor_ + upFactor_ - 1) / upFactor_;
+    taps_ = BASE_TAPS * std::max(1, decimation);
+    double cutoff = CUTOFF * std::min(1.0, static_cast<double>(upFactor_) / downFactor_);
+
+    // Row p holds the taps for outputs that fall p / L of the way between
+    // two input samples. The window starts taps / 2 - 1 samples before the
+    // earlier of them.
+    double halfWidth = taps_ / 2.0;
+    coefficients_.assign(static_cast<size_t>(upFactor_) * taps_, 0.0f);
+    std::vector<double> taps(taps_);
+    for (int phase = 0; phase < upFactor_; phase++) {
+        float* row = coefficients_.data() + static_cast<size_t>(phase) * taps_;
+        double offset = static_cast<double>(phase) / upFactor_;
+
+        double sum = 0.0;
+        for (int k = 0; k < taps_; k++) {
+            double x = k - (halfWidth - 1.0) - offset;
+            double sinc = x == 0.0 ? 1.0 : std::sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+            double window = 0.42 + 0.5 * std::cos(M_PI * x / halfWidth) + 0.08 * std::cos(2.0 * M_PI * x / halfWidth);
+            taps[k] = sinc * window;
+            sum += taps[k];
+        }
+
+        // Unity gain at DC in every phase, so a constant stays constant
+        for (int k = 0; k < taps_; k++) {
+            row[k] = static_cast<float>(taps[k] / sum);
+        }
+    }
+
+    // Start with the window's lead-in of silence
+    input_.assign(static_cast<size_t>(taps_ + INPUT_BLOCK), 0.0f);
+    filled_ = taps_ / 2 - 1;
+    position_ = 0;
+    phase_ = 0;
+    return true;
+}
+
+int Resampler::resample(float* out, int samples) {
+    int produced = 0;
+    while (produced < samples && position_ + taps_ <= filled_) {
+        const float* row = coefficients_.data() + static_cast<size_t>(phase_) * taps_;
+        out[produced++] = dot(row, input_.data() + position_, taps_);
+
+        phase_ += downFactor_;
+        position_ += phase_ / upFactor_;
+        phase_ %= upFactor_;
+    }
+    return produced;
+}
+
+float* Resampler::prepareInput() {
+    // Fewer than taps_ samples are left, since the next window didn't fit
+    int kept = std::max(0, filled_ - position_);
+    std::copy(input_.begin() + (filled_ - kept), input_.begin() + filled_, input_.begin());
+    position_ -= filled_ - kept;
+    filled_ = kept + INPUT_BLOCK;
+    return input_.data() + kept;
+}
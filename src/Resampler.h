@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Polyphase FIR sample rate converter for one mono stream. The rate ratio
+// is reduced to L/M, and each of the L phases of a windowed sinc low-pass
+// gets its own row of taps, so every output sample is one dot product,
+// computed four taps at a time with SSE2 where available. SDL-free; the
+// Mixer uses it for device rates the synths don't run at.
+class Resampler {
+public:
+    // Converts from inputRate to outputRate from here on, clearing any
+    // history. Fails when the ratio needs more than MAX_PHASES phases.
+    // Allocates, so not safe while rendering.
+    bool configure(int inputRate, int outputRate);
+
+    // Fills out with samples at the output rate, calling
+    // renderInput(float* in, int count) whenever more input is needed
+    template <typename RenderInput>
+    void render(float* out, int samples, RenderInput&& renderInput) {
+        while (samples > 0) {
+            int produced = resample(out, samples);
+            out += produced;
+            samples -= produced;
+            if (samples > 0) {
+                renderInput(prepareInput(), INPUT_BLOCK);
+            }
+        }
+    }
+
+    static constexpr int MAX_PHASES = 1024;
+    static constexpr int INPUT_BLOCK = 256;
+
+    // Taps per phase when upsampling; downsampling by a factor of n uses n
+    // times as many, so the filter narrows with the output band
+    static constexpr int BASE_TAPS = 48;
+
+private:
+    // Produces as many of samples as the buffered input allows
+    int resample(float* out, int samples);
+
+    // Drops consumed input and returns room for INPUT_BLOCK more
+    float* prepareInput();
+
+    int upFactor_ = 1;      // L
+    int downFactor_ = 1;    // M
+    int taps_ = 0;
+    std::vector<float> coefficients_;   // upFactor_ rows of taps_
+
+    // Input history; the next output's window starts at position_
+    std::vector<float> input_;
+    int filled_ = 0;
+    int position_ = 0;
+    int phase_ = 0;
+};
@@ -0,0 +1,205 @@
+#include "Simulation.h"
+#include "Replay.h"
+#include <algorithm>
+
+Simulation::Simulation(uint32_t seed) {
+    reset(seed);
+}
+
+void Simulation::reset(uint32_t seed) {
+    seed_ = seed;
+    rng_.seed(seed);
+
+    board_.clear();
+    gameOver_ = false;
+    score_ = 0;
+    level_ = 1;
+    totalLines_ = 0;
+    piecesPlaced_ = 0;
+    timeMs_ = 0;
+    lastDropMs_ = 0;
+    dropInterval_ = INITIAL_DROP_INTERVAL;
+
+    nextPiece_ = Tetromino(randomType());
+    spawnNewPiece();
+}
+
+uint32_t Simulation::step(Input input, uint32_t dtMs) {
+    events_ = 0;
+
+    // Restart begins a new game, so it isn't part of this game's replay
+    if (recorder_ && !gameOver_ && input != Input::None && input != Input::Restart) {
+        recorder_->record(timeMs_, input);
+    }
+
+    applyInput(input);
+
+    timeMs_ += dtMs;
+    if (!gameOver_) {
+        applyGravity();
+    }
+
+    return events_;
+}
+
+void Simulation::applyInput(Input input) {
+    if (gameOver_) {
+        if (input == Input::Restart) {
+            // Derive the next game's seed from this one so whole sessions replay
+            reset(rng_());
+            events_ |= eventBit(GameEvent::Restart);
+        }
+        return;
+    }
+
+    switch (input) {
+        case Input::Left:
+            if (tryMove(-1, 0)) {
+                events_ |= eventBit(GameEvent::Move);
+            }
+            break;
+        case Input::Right:
+            if (tryMove(1, 0)) {
+                events_ |= eventBit(GameEvent::Move);
+            }
+            break;
+        case Input::SoftDrop:
+            if (tryMove(0, 1)) {
+                score_ += 1; // Soft drop bonus
+                events_ |= eventBit(GameEvent::Move);
+            }
+            break;
+        case Input::Rotate:
+            if (tryRotate()) {
+                events_ |= eventBit(GameEvent::Rotate);
+            }
+            break;
+        case Input::HardDrop:
+            hardDrop();
+            break;
+        case Input::None:
+        case Input::Restart:
+            break;
+    }
+}
+
+void Simulation::applyGravity() {
+    // Drops are due on a fixed schedule, so splitting a step into several
+    // smaller ones gives exactly the same result
+    while (timeMs_ - lastDropMs_ >= dropInterval_) {
+        lastDropMs_ += dropInterval_;
+        if (!tryMove(0, 1)) {
+            lockPiece();
+            if (gameOver_) break;
+        }
+    }
+}
+
+TetrominoType Simulation::randomType() {
+    // uniform_int_distribution differs between standard libraries, which
+    // would break replays recorded on another platform. mt19937 itself is
+    // fully specified, so reduce its output by hand, rejecting the top
+    // partial range to stay unbiased.
+    constexpr uint32_t TYPES = static_cast<uint32_t>(TetrominoType::Count);
+    constexpr uint32_t LIMIT = 0xFFFFFFFFu - 0xFFFFFFFFu % TYPES;
+
+    uint32_t value;
+    do {
+        value = static_cast<uint32_t>(rng_());
+    } while (value >= LIMIT);
+
+    return static_cast<TetrominoType>(value % TYPES);
+}
+
+void Simulation::spawnNewPiece() {
+    currentPiece_ = nextPiece_;
+    nextPiece_ = Tetromino(randomType());
+
+    // Position piece at top center of board
+    currentPiece_.setPosition(Board::WIDTH / 2 - 2, 0);
+
+    // Check if spawn position is valid (game over if not)
+    if (!board_.isValidPosition(currentPiece_)) {
+        gameOver_ = true;
+        events_ |= eventBit(GameEvent::GameOver);
+    }
+}
+
+void Simulation::lockPiece() {
+    board_.placePiece(currentPiece_);
+    piecesPlaced_++;
+
+    int linesCleared = board_.clearLines();
+    if (linesCleared > 0) {
+        score_ += calculateScore(linesCleared);
+        totalLines_ += linesCleared;
+
+        events_ |= eventBit(linesCleared == 4 ? GameEvent::Tetris : GameEvent::LineClear);
+
+        // Level up
+        int newLevel = totalLines_ / LINES_PER_LEVEL + 1;
+        if (newLevel > level_) {
+            level_ = newLevel;
+            // Clamped before the cast, so high levels can't wrap to a huge interval
+            dropInterval_ = static_cast<uint32_t>(std::max<int>(MIN_DROP_INTERVAL, 500 - (level_ - 1) * 50));
+            events_ |= eventBit(GameEvent::LevelUp);
+        }
+    }
+
+    spawnNewPiece();
+}
+
+bool Simulation::tryMove(int dx, int dy) {
+    currentPiece_.move(dx, dy);
+
+    if (!board_.isValidPosition(currentPiece_)) {
+        currentPiece_.move(-dx, -dy);
+        return false;
+    }
+
+    return true;
+}
+
+bool Simulation::tryRotate() {
+    return rotateWithKicks(board_, currentPiece_);
+}
+
+bool Simulation::rotateWithKicks(const Board& board, Tetromino& piece) {
+    piece.rotateClockwise();
+
+    if (!board.isValidPosition(piece)) {
+        // Try wall kicks
+        static const int kicks[][2] = {{-1, 0}, {1, 0}, {-2, 0}, {2, 0}, {0, -1}};
+
+        for (const auto& kick : kicks) {
+            piece.move(kick[0], kick[1]);
+            if (board.isValidPosition(piece)) {
+                return true;
+            }
+            piece.move(-kick[0], -kick[1]);
+        }
+
+        // No valid position found, revert rotation
+        piece.rotateCounterClockwise();
+        return false;
+    }
+
+    return true;
+}
+
+void Simulation::hardDrop() {
+    int dropDistance = 0;
+    while (tryMove(0, 1)) {
+        dropDistance++;
+    }
+
+    score_ += dropDistance * 2; // Hard drop bonus
+    events_ |= eventBit(GameEvent::Drop);
+    lockPiece();
+}
+
+int Simulation::calculateScore(int linesCleared) {
+    // Classic Tetris scoring
+    static const int scoreTable[] = {0, 100, 300, 500, 800};
+    return scoreTable[linesCleared] * level_;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Board.h"
+#include "Tetromino.h"
+#include <cstdint>
+#include <random>
+
+class Replay;
+
+// Player actions, one per step
+enum class Input : uint8_t {
+    None,
+    Left,
+    Right,
+    SoftDrop,
+    Rotate,
+    HardDrop,
+    Restart     // Only honoured once the game is over
+};
+
+// Things that happened during a step, reported as bits of the step result
+// so a frontend can play sounds or music without the rules knowing about it
+enum class GameEvent : uint8_t {
+    Move,
+    Rotate,
+    Drop,
+    LineClear,
+    Tetris,     // 4 lines at once
+    LevelUp,
+    GameOver,
+    Restart
+};
+
+constexpr uint32_t eventBit(GameEvent event) {
+    return 1u << static_cast<uint32_t>(event);
+}
+
+// The complete game rules with no platform dependencies. Time only moves
+// when the caller passes it in, so a run is fully determined by the seed
+// and the sequence of step() calls.
+class Simulation {
+public:
+    explicit Simulation(uint32_t seed);
+
+    void reset(uint32_t seed);
+
+    // Applies the input at the current time, then advances the clock by
+    // dtMs and applies gravity. Returns the GameEvent bits that occurred.
+    uint32_t step(Input input, uint32_t dtMs);
+
+    // Single rule operations, also driven by step()
+    bool tryMove(int dx, int dy);
+    bool tryRotate();
+    void hardDrop();
+
+    // Rotates piece clockwise on board, trying wall kicks if needed.
+    // Leaves piece unchanged and returns false if no kick fits.
+    static bool rotateWithKicks(const Board& board, Tetromino& piece);
+
+    const Board& board() const { return board_; }
+    const Tetromino& currentPiece() const { return currentPiece_; }
+    const Tetromino& nextPiece() const { return nextPiece_; }
+
+    // Called by a frontend once it has drawn the board's dirty rows
+    void clearDirtyRows() { board_.clearDirtyRows(); }
+
+    bool isGameOver() const { return gameOver_; }
+    int score() const { return score_; }
+    int level() const { return level_; }
+    int totalLines() const { return totalLines_; }
+    int piecesPlaced() const { return piecesPlaced_; }
+    uint32_t seed() const { return seed_; }
+    uint64_t elapsedMs() const { return timeMs_; }
+
+    // Gravity schedule, so a frontend can interpolate between drops
+    uint32_t dropInterval() const { return dropInterval_; }
+    uint64_t nextDropMs() const { return lastDropMs_ + dropInterval_; }
+
+    // Every input applied during a game is appended to replay, whether it
+    // comes from the keyboard or the bot. Pass nullptr to stop recording.
+    void setRecorder(Replay* replay) { recorder_ = replay; }
+
+    static constexpr int LINES_PER_LEVEL = 10;
+    static constexpr uint32_t INITIAL_DROP_INTERVAL = 500; // milliseconds
+    static constexpr uint32_t MIN_DROP_INTERVAL = 50;
+
+private:
+    TetrominoType randomType();
+    void spawnNewPiece();
+    void lockPiece();
+    void applyInput(Input input);
+    void applyGravity();
+
+    int calculateScore(int linesCleared);
+
+    Board board_;
+
+    Tetromino currentPiece_{TetrominoType::I};
+    Tetromino nextPiece_{TetrominoType::I};
+
+    std::mt19937 rng_;
+    uint32_t seed_ = 0;
+
+    bool gameOver_ = false;
+
+    int score_ = 0;
+    int level_ = 1;
+    int totalLines_ = 0;
+    int piecesPlaced_ = 0;
+
+    uint64_t timeMs_ = 0;
+    uint64_t lastDropMs_ = 0;
+    uint32_t dropInterval_ = INITIAL_DROP_INTERVAL;
+
+    // Events raised since the start of the current step
+    uint32_t events_ = 0;
+
+    Replay* recorder_ = nullptr;
+};
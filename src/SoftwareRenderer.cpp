@@ -0,0 +1,370 @@
+#include "SoftwareRenderer.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TETRIS_SOFT_SSE2 1
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TETRIS_SOFT_AVX2 1
+#endif
+
+namespace {
+
+uint32_t argb(int r, int g, int b) {
+    return 0xFF000000u | static_cast<uint32_t>(r) << 16 | static_cast<uint32_t>(g) << 8 | static_cast<uint32_t>(b);
+}
+
+uint32_t argb(const Color& color) {
+    return argb(color.r, color.g, color.b);
+}
+
+int glyphIndex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return 10 + (c - 'A');
+    if (c >= 'a' && c <= 'z') return 10 + (c - 'a');
+    if (c == '.') return 36;
+    if (c == ':') return 37;
+    return -1;
+}
+
+char glyphChar(int index) {
+    if (index < 10) return static_cast<char>('0' + index);
+    if (index < 36) return static_cast<char>('A' + index - 10);
+    return index == 36 ? '.' : ':';
+}
+
+// Span kernels. Each writes n pixels starting at dst.
+
+void fillSpan(uint32_t* dst, int n, uint32_t color) {
+    int i = 0;
+#ifdef TETRIS_SOFT_AVX2
+    __m256i wide = _mm256_set1_epi32(static_cast<int>(color));
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), wide);
+    }
+#endif
+#ifdef TETRIS_SOFT_SSE2
+    __m128i value = _mm_set1_epi32(static_cast<int>(color));
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), value);
+    }
+#endif
+    // Tail bounded by the remaining count
+    int count = n - i;
+    for (int k = 0; k < count; k++) {
+        dst[i + k] = color;
+    }
+}
+
+// Exact t / 255 for t in [0, 255 * 255]
+inline uint32_t div255(uint32_t t) {
+    return (t + 1 + (t >> 8)) >> 8;
+}
+
+// dst = (color * alpha + dst * (255 - alpha)) / 255 per channel
+void blendSpan(uint32_t* dst, int n, uint32_t color, uint8_t alpha) {
+    int i = 0;
+#ifdef TETRIS_SOFT_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i inverse = _mm_set1_epi16(static_cast<short>(255 - alpha));
+    // color * alpha for two pixels' worth of 16-bit channels
+    const __m128i source = _mm_mullo_epi16(
+        _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero),
+        _mm_set1_epi16(alpha));
+
+    auto blendHalf = [&](__m128i half) {
+        __m128i t = _mm_add_epi16(source, _mm_mullo_epi16(half, inverse));
+        t = _mm_add_epi16(_mm_add_epi16(t, one), _mm_srli_epi16(t, 8));
+        return _mm_srli_epi16(t, 8);
+    };
+
+    for (; i + 4 <= n; i += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i low = blendHalf(_mm_unpacklo_epi8(pixels, zero));
+        __m128i high = blendHalf(_mm_unpackhi_epi8(pixels, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(low, high));
+    }
+#endif
+    for (; i < n; i++) {
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t s = (color >> shift) & 0xFF;
+            uint32_t d = (dst[i] >> shift) & 0xFF;
+            result |= div255(s * alpha + d * (255u - alpha)) << shift;
+        }
+        dst[i] = result;
+    }
+}
+
+// dst = mask ? color : dst
+void maskedSpan(uint32_t* dst, const uint32_t* mask, int n, uint32_t color) {
+    int i = 0;
+#ifdef TETRIS_SOFT_AVX2
+    __m256i wide = _mm256_set1_epi32(static_cast<int>(color));
+    for (; i + 8 <= n; i += 8) {
+        __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                            _mm256_or_si256(_mm256_andnot_si256(m, d), _mm256_and_si256(m, wide)));
+    }
+#endif
+#ifdef TETRIS_SOFT_SSE2
+    __m128i value = _mm_set1_epi32(static_cast<int>(color));
+    for (; i + 4 <= n; i += 4) {
+        __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_or_si128(_mm_andnot_si128(m, d), _mm_and_si128(m, value)));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = (dst[i] & ~mask[i]) | (color & mask[i]);
+    }
+}
+
+// Clips [x, x + w) x [y, y + h) to the framebuffer; false if nothing is left
+bool clip(int& x, int& y, int& w, int& h) {
+    int x1 = std::min(x + w, SoftwareRenderer::WIDTH);
+    int y1 = std::min(y + h, SoftwareRenderer::HEIGHT);
+    x = std::max(x, 0);
+    y = std::max(y, 0);
+    w = x1 - x;
+    h = y1 - y;
+    return w > 0 && h > 0;
+}
+
+} // namespace
+
+SoftwareRenderer::SoftwareRenderer()
+    : pixels_(WIDTH * HEIGHT, 0) {
+    constexpr int bevel = render_style::BEVEL;
+
+    // Same bevel as the SDL renderer's atlas: the shadow edges go last, so
+    // they win at the two corners shared with the highlight
+    for (size_t t = 0; t < cells_.size(); t++) {
+        Color color = Tetromino::getColorForType(static_cast<TetrominoType>(t));
+        uint32_t highlight = argb(std::min(255, color.r + bevel), std::min(255, color.g + bevel), std::min(255, color.b + bevel));
+        uint32_t shadow = argb(std::max(0, color.r - bevel), std::max(0, color.g - bevel), std::max(0, color.b - bevel));
+
+        std::vector<uint32_t>& cell = cells_[t];
+        cell.assign(CELL_SPRITE * CELL_SPRITE, argb(color));
+        for (int i = 0; i < CELL_SPRITE; i++) {
+            cell[i] = highlight;                                       // Top
+            cell[i * CELL_SPRITE] = highlight;                         // Left
+        }
+        for (int i = 0; i < CELL_SPRITE; i++) {
+            cell[(CELL_SPRITE - 1) * CELL_SPRITE + i] = shadow;        // Bottom
+            cell[i * CELL_SPRITE + CELL_SPRITE - 1] = shadow;          // Right
+        }
+    }
+
+    for (int scale = 1; scale <= MAX_TEXT_SCALE; scale++) {
+        const int width = render_style::GLYPH_WIDTH * scale;
+        const int height = render_style::GLYPH_HEIGHT * scale;
+        std::vector<uint32_t>& masks = glyphMasks_[scale - 1];
+        masks.assign(GLYPH_COUNT * width * height, 0);
+
+        for (int index = 0; index < GLYPH_COUNT; index++) {
+            const uint8_t* bits = render_style::glyphFor(glyphChar(index));
+            uint32_t* glyph = masks.data() + index * width * height;
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    bool lit = bits[y / scale] & (1 << (render_style::GLYPH_WIDTH - 1 - x / scale));
+                    glyph[y * width + x] = lit ? 0xFFFFFFFFu : 0u;
+                }
+            }
+        }
+    }
+
+    paintBackground();
+    background_ = pixels_;
+}
+
+void SoftwareRenderer::paintBackground() {
+    using namespace render_style;
+
+    fillRect(0, 0, WIDTH, HEIGHT, argb(WINDOW_COLOR));
+    fillRect(BOARD_X, BOARD_Y, Board::WIDTH * CELL_SIZE, Board::HEIGHT * CELL_SIZE, argb(BOARD_COLOR));
+
+    // Grid lines include both end points, like SDL_RenderDrawLine
+    uint32_t grid = argb(GRID_COLOR);
+    for (int x = 0; x <= Board::WIDTH; x++) {
+        fillRect(BOARD_X + x * CELL_SIZE, BOARD_Y, 1, Board::HEIGHT * CELL_SIZE + 1, grid);
+    }
+    for (int y = 0; y <= Board::HEIGHT; y++) {
+        fillRect(BOARD_X, BOARD_Y + y * CELL_SIZE, Board::WIDTH * CELL_SIZE + 1, 1, grid);
+    }
+
+    uint32_t label = argb(LABEL_COLOR);
+    drawText("NEXT", SIDEBAR_X, NEXT_LABEL_Y, 2, label);
+    fillRect(SIDEBAR_X, PREVIEW_Y, 4 * CELL_SIZE, 4 * CELL_SIZE, argb(BOARD_COLOR));
+    drawRectOutline(SIDEBAR_X, PREVIEW_Y, 4 * CELL_SIZE, 4 * CELL_SIZE, argb(PREVIEW_BORDER_COLOR));
+
+    drawText("TIME", SIDEBAR_X, STATS_Y, 2, label);
+    drawText("SCORE", SIDEBAR_X, STATS_Y + STATS_ROW_HEIGHT, 2, label);
+    drawText("LEVEL", SIDEBAR_X, STATS_Y + STATS_ROW_HEIGHT * 2, 2, label);
+    drawText("LINES", SIDEBAR_X, STATS_Y + STATS_ROW_HEIGHT * 3, 2, label);
+}
+
+void SoftwareRenderer::clear() {
+    std::memcpy(pixels_.data(), background_.data(), pixels_.size() * sizeof(uint32_t));
+}
+
+void SoftwareRenderer::fillRect(int x, int y, int w, int h, uint32_t color) {
+    if (!clip(x, y, w, h)) return;
+    for (int row = y; row < y + h; row++) {
+        fillSpan(pixels_.data() + row * WIDTH + x, w, color);
+    }
+}
+
+void SoftwareRenderer::blendRect(int x, int y, int w, int h, uint32_t color, uint8_t alpha) {
+    if (!clip(x, y, w, h)) return;
+    for (int row = y; row < y + h; row++) {
+        blendSpan(pixels_.data() + row * WIDTH + x, w, color, alpha);
+    }
+}
+
+void SoftwareRenderer::drawRectOutline(int x, int y, int w, int h, uint32_t color) {
+    fillRect(x, y, w, 1, color);
+    fillRect(x, y + h - 1, w, 1, color);
+    fillRect(x, y, 1, h, color);
+    fillRect(x + w - 1, y, 1, h, color);
+}
+
+void SoftwareRenderer::drawCell(int x, int y, TetrominoType type, int offsetX, int offsetY) {
+    int left = offsetX + x * render_style::CELL_SIZE + 1;
+    int top = offsetY + y * render_style::CELL_SIZE + 1;
+
+    int clippedX = left, clippedY = top, w = CELL_SPRITE, h = CELL_SPRITE;
+    if (!clip(clippedX, clippedY, w, h)) return;
+
+    const std::vector<uint32_t>& cell = cells_[static_cast<size_t>(type)];
+    for (int row = 0; row < h; row++) {
+        const uint32_t* source = cell.data() + (clippedY - top + row) * CELL_SPRITE + (clippedX - left);
+        std::memcpy(pixels_.data() + (clippedY + row) * WIDTH + clippedX, source, w * sizeof(uint32_t));
+    }
+}
+
+void SoftwareRenderer::drawChar(char c, int x, int y, int scale, uint32_t color) {
+    int index = glyphIndex(c);
+    if (index < 0 || scale < 1 || scale > MAX_TEXT_SCALE) return;
+
+    const int width = render_style::GLYPH_WIDTH * scale;
+    const int height = render_style::GLYPH_HEIGHT * scale;
+    const uint32_t* glyph = glyphMasks_[scale - 1].data() + index * width * height;
+
+    int clippedX = x, clippedY = y, w = width, h = height;
+    if (!clip(clippedX, clippedY, w, h)) return;
+
+    for (int row = 0; row < h; row++) {
+        const uint32_t* mask = glyph + (clippedY - y + row) * width + (clippedX - x);
+        maskedSpan(pixels_.data() + (clippedY + row) * WIDTH + clippedX, mask, w, color);
+    }
+}
+
+void SoftwareRenderer::drawText(const char* text, int x, int y, int scale, uint32_t color) {
+    int charWidth = (render_style::GLYPH_WIDTH + 1) * scale;
+    for (int i = 0; text[i] != '\0'; i++) {
+        drawChar(text[i], x + i * charWidth, y, scale, color);
+    }
+}
+
+void SoftwareRenderer::drawNumber(int number, int x, int y, int scale, int minDigits, uint32_t color) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "%0*d", minDigits, number);
+    drawText(text, x, y, scale, color);
+}
+
+void SoftwareRenderer::drawBoard(const Board& board) {
+    for (int y = 0; y < Board::HEIGHT; y++) {
+        for (int x = 0; x < Board::WIDTH; x++) {
+            auto cell = board.getCell(x, y);
+            if (cell.has_value()) {
+                drawCell(x, y, cell.value(), render_style::BOARD_X, render_style::BOARD_Y);
+            }
+        }
+    }
+}
+
+void SoftwareRenderer::drawPiece(const Tetromino& piece, int offsetY) {
+    for (int y = 0; y < Tetromino::SIZE; y++) {
+        for (int x = 0; x < Tetromino::SIZE; x++) {
+            if (piece.isFilled(x, y) && piece.getY() + y >= 0) {
+                drawCell(piece.getX() + x, piece.getY() + y, piece.getType(),
+                         render_style::BOARD_X, render_style::BOARD_Y + offsetY);
+            }
+        }
+    }
+}
+
+void SoftwareRenderer::drawNextPiece(const Tetromino& piece) {
+    for (int y = 0; y < Tetromino::SIZE; y++) {
+        for (int x = 0; x < Tetromino::SIZE; x++) {
+            if (piece.isFilled(x, y)) {
+                drawCell(x, y, piece.getType(), render_style::SIDEBAR_X, render_style::PREVIEW_Y);
+            }
+        }
+    }
+}
+
+void SoftwareRenderer::drawStats(int score, int level, int lines, int timeSeconds) {
+    using namespace render_style;
+
+    const int scale = 2;
+    const int digitWidth = (GLYPH_WIDTH + 1) * scale;
+    int y = STATS_Y + STATS_VALUE_OFFSET;
+
+    // Minutes, colon and seconds laid out like Renderer::drawTime
+    uint32_t time = argb(TIME_COLOR);
+    drawNumber(timeSeconds / 60, SIDEBAR_X, y, scale, 2, time);
+    drawChar(':', SIDEBAR_X + 2 * digitWidth + 2, y, scale, time);
+    drawNumber(timeSeconds % 60, SIDEBAR_X + 2 * digitWidth + scale + 4, y, scale, 2, time);
+
+    drawNumber(score, SIDEBAR_X, y + STATS_ROW_HEIGHT, scale, 1, argb(SCORE_COLOR));
+    drawNumber(level, SIDEBAR_X, y + STATS_ROW_HEIGHT * 2, scale, 1, argb(LEVEL_COLOR));
+    drawNumber(lines, SIDEBAR_X, y + STATS_ROW_HEIGHT * 3, scale, 1, argb(LINES_COLOR));
+}
+
+void SoftwareRenderer::drawGameOver() {
+    using namespace render_style;
+
+    blendRect(BOARD_X, BOARD_Y, Board::WIDTH * CELL_SIZE, Board::HEIGHT * CELL_SIZE, argb(0, 0, 0), GAME_OVER_ALPHA);
+
+    const int scale = 3;
+    int centerX = BOARD_X + (Board::WIDTH * CELL_SIZE) / 2;
+    int centerY = BOARD_Y + (Board::HEIGHT * CELL_SIZE) / 2;
+    int wordWidth = 4 * (GLYPH_WIDTH + 1) * scale;
+
+    uint32_t color = argb(GAME_OVER_COLOR);
+    drawText("GAME", centerX - wordWidth / 2, centerY - 30, scale, color);
+    drawText("OVER", centerX - wordWidth / 2, centerY + 5, scale, color);
+}
+
+bool SoftwareRenderer::writePpm(const std::string& path) const {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    std::fprintf(file, "P6\n%d %d\n255\n", WIDTH, HEIGHT);
+
+    std::vector<uint8_t> row(WIDTH * 3);
+    bool ok = true;
+    for (int y = 0; y < HEIGHT && ok; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            uint32_t p = pixels_[y * WIDTH + x];
+            row[x * 3 + 0] = static_cast<uint8_t>(p >> 16);
+            row[x * 3 + 1] = static_cast<uint8_t>(p >> 8);
+            row[x * 3 + 2] = static_cast<uint8_t>(p);
+        }
+        ok = std::fwrite(row.data(), 1, row.size(), file) == row.size();
+    }
+
+    return std::fclose(file) == 0 && ok;
+}
+
+bool SoftwareRenderer::writeRaw(std::FILE* out) const {
+    return std::fwrite(pixels_.data(), sizeof(uint32_t), pixels_.size(), out) == pixels_.size();
+}
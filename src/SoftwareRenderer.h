@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Board.h"
+#include "RenderStyle.h"
+#include "Tetromino.h"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Draws the same picture as Renderer into a CPU-side framebuffer, with no
+// window or SDL dependency, for headless capture and pixel-exact tests.
+// Pixels are 32-bit 0xAARRGGBB, which is BGRA byte order on little-endian
+// machines. Fills, blends and glyph blits use SSE2, or AVX2 when the
+// compiler targets it.
+class SoftwareRenderer {
+public:
+    static constexpr int WIDTH = render_style::WINDOW_WIDTH;
+    static constexpr int HEIGHT = render_style::WINDOW_HEIGHT;
+
+    SoftwareRenderer();
+
+    void clear();
+
+    void drawBoard(const Board& board);
+    // offsetY shifts the piece down by that many pixels, for smooth falling
+    void drawPiece(const Tetromino& piece, int offsetY = 0);
+    void drawNextPiece(const Tetromino& piece);
+    void drawStats(int score, int level, int lines, int timeSeconds);
+    void drawGameOver();
+
+    const uint32_t* pixels() const { return pixels_.data(); }
+    uint32_t pixel(int x, int y) const { return pixels_[y * WIDTH + x]; }
+
+    // Binary PPM (P6), RGB
+    bool writePpm(const std::string& path) const;
+    // One frame of raw 32-bit pixels, e.g. for ffmpeg -f rawvideo -pix_fmt bgra
+    bool writeRaw(std::FILE* out) const;
+
+private:
+    void fillRect(int x, int y, int w, int h, uint32_t color);
+    void blendRect(int x, int y, int w, int h, uint32_t color, uint8_t alpha);
+    void drawRectOutline(int x, int y, int w, int h, uint32_t color);
+
+    void drawCell(int x, int y, TetrominoType type, int offsetX, int offsetY);
+    void drawChar(char c, int x, int y, int scale, uint32_t color);
+    void drawText(const char* text, int x, int y, int scale, uint32_t color);
+    void drawNumber(int number, int x, int y, int scale, int minDigits, uint32_t color);
+
+    // Static chrome, painted into pixels_ once and kept in background_
+    void paintBackground();
+
+    static constexpr int CELL_SPRITE = render_style::CELL_SIZE - 2;
+    static constexpr int MAX_TEXT_SCALE = 3;
+    static constexpr int GLYPH_COUNT = 10 + 26 + 2; // Digits, letters, point, colon
+
+    std::vector<uint32_t> pixels_;
+    std::vector<uint32_t> background_;
+
+    // Beveled cell per piece type, CELL_SPRITE x CELL_SPRITE
+    std::array<std::vector<uint32_t>, static_cast<size_t>(TetrominoType::Count)> cells_;
+
+    // Per scale and glyph, one all-ones or all-zeros word per pixel, so
+    // glyphs can be blitted with and/andnot/or instead of per-pixel tests
+    std::array<std::vector<uint32_t>, MAX_TEXT_SCALE> glyphMasks_;
+};
@@ -1,70 +1,58 @@
 #include "Sound.h"
 #include <algorithm>
-#include <cstring>
 
-Sound::Sound() {}
-
-Sound::~Sound() {
-    shutdown();
+Sound::Sound() {
+    renderEffects();
 }
 
-bool Sound::init() {
-    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
-        return false;
-    }
+void Sound::setSampleRate(int sampleRate) {
+    sampleRate_ = sampleRate;
+    voices_ = {};
+    renderEffects();
+}
 
-    SDL_AudioSpec desired;
-    SDL_memset(&desired, 0, sizeof(desired));
-    desired.freq = SAMPLE_RATE;
-    desired.format = AUDIO_F32SYS;
-    desired.channels = 1;
-    desired.samples = 1024;
-    desired.callback = audioCallback;
-    desired.userdata = this;
-
-    audioDevice_ = SDL_OpenAudioDevice(nullptr, 0, &desired, &audioSpec_, 0);
-    if (audioDevice_ == 0) {
-        return false;
+void Sound::render(float* out, int samples) {
+    SoundEffect effect;
+    while (commands_.pop(effect)) {
+        startVoice(effect);
     }
 
-    SDL_PauseAudioDevice(audioDevice_, 0); // Start audio
-    return true;
-}
+    std::fill(out, out + samples, 0.0f);
+    for (Voice& voice : voices_) {
+        uint32_t count = std::min<uint32_t>(voice.end - voice.position, static_cast<uint32_t>(samples));
+        if (count == 0) continue;
 
-void Sound::shutdown() {
-    if (audioDevice_ != 0) {
-        SDL_CloseAudioDevice(audioDevice_);
-        audioDevice_ = 0;
+        const float* source = bank_.data() + voice.position;
+        for (uint32_t i = 0; i < count; i++) {
+            out[i] += source[i];
+        }
+        voice.position += count;
     }
 }
 
-void Sound::audioCallback(void* userdata, Uint8* stream, int len) {
-    Sound* sound = static_cast<Sound*>(userdata);
-    float* floatStream = reinterpret_cast<float*>(stream);
-    int samples = len / sizeof(float);
-
-    std::lock_guard<std::mutex> lock(sound->bufferMutex_);
-
-    for (int i = 0; i < samples; i++) {
-        if (sound->bufferPosition_ < sound->audioBuffer_.size()) {
-            floatStream[i] = sound->audioBuffer_[sound->bufferPosition_++];
-        } else {
-            floatStream[i] = 0.0f;
+void Sound::startVoice(SoundEffect effect) {
+    Voice* target = &voices_[0];
+    for (Voice& voice : voices_) {
+        if (voice.position == voice.end) {
+            target = &voice;
+            break;
+        }
+        if (voice.started < target->started) {
+            target = &voice;
         }
     }
 
-    // Clear consumed samples
-    if (sound->bufferPosition_ >= sound->audioBuffer_.size()) {
-        sound->audioBuffer_.clear();
-        sound->bufferPosition_ = 0;
-    }
+    const EffectRange& range = effectRanges_[static_cast<size_t>(effect)];
+    target->position = range.offset;
+    target->end = range.offset + range.length;
+    target->started = triggerCount_++;
 }
 
-void Sound::generateTone(float frequency, float duration, float volume) {
-    int samples = static_cast<int>(SAMPLE_RATE * duration);
+void Sound::generateTone(std::vector<float>& out, float frequency, float duration, float volume) const {
+    int samples = static_cast<int>(sampleRate_ * duration);
 
     for (int i = 0; i < samples; i++) {
-        float t = static_cast<float>(i) / SAMPLE_RATE;
+        float t = static_cast<float>(i) / sampleRate_;
         float envelope = 1.0f;
 
         // Apply envelope (attack and decay)
@@ -78,15 +66,15 @@ void Sound::generateTone(float frequency, float duration, float volume) {
         }
 
         float sample = std::sin(2.0f * M_PI * frequency * t) * volume * envelope;
-        audioBuffer_.push_back(sample);
+        out.push_back(sample);
     }
 }
 
-void Sound::generateSweep(float startFreq, float endFreq, float duration, float volume) {
-    int samples = static_cast<int>(SAMPLE_RATE * duration);
+void Sound::generateSweep(std::vector<float>& out, float startFreq, float endFreq, float duration, float volume) const {
+    int samples = static_cast<int>(sampleRate_ * duration);
 
     for (int i = 0; i < samples; i++) {
-        float t = static_cast<float>(i) / SAMPLE_RATE;
+        float t = static_cast<float>(i) / sampleRate_;
         float progress = t / duration;
 
         // Interpolate frequency
@@ -104,63 +92,73 @@ void Sound::generateSweep(float startFreq, float endFreq, float duration, float
         }
 
         float sample = std::sin(2.0f * M_PI * frequency * t) * volume * envelope;
-        audioBuffer_.push_back(sample);
+        out.push_back(sample);
     }
 }
 
 void Sound::play(SoundEffect effect) {
-    std::lock_guard<std::mutex> lock(bufferMutex_);
-
-    // Clear any existing audio for immediate response
-    audioBuffer_.clear();
-    bufferPosition_ = 0;
-
-    switch (effect) {
-        case SoundEffect::Move:
-            // Short low click
-            generateTone(200.0f, 0.05f, 0.2f);
-            break;
-
-        case SoundEffect::Rotate:
-            // Quick ascending tone
-            generateSweep(300.0f, 500.0f, 0.08f, 0.25f);
-            break;
-
-        case SoundEffect::Drop:
-            // Thud sound - low frequency
-            generateTone(100.0f, 0.1f, 0.4f);
-            generateTone(80.0f, 0.1f, 0.3f);
-            break;
-
-        case SoundEffect::LineClear:
-            // Pleasant chime
-            generateTone(523.25f, 0.1f, 0.3f);  // C5
-            generateTone(659.25f, 0.1f, 0.3f);  // E5
-            generateTone(783.99f, 0.15f, 0.3f); // G5
-            break;
-
-        case SoundEffect::Tetris:
-            // Triumphant fanfare for 4 lines
-            generateTone(523.25f, 0.1f, 0.35f);  // C5
-            generateTone(659.25f, 0.1f, 0.35f);  // E5
-            generateTone(783.99f, 0.1f, 0.35f);  // G5
-            generateTone(1046.50f, 0.2f, 0.4f);  // C6
-            break;
+    // A full queue means the audio thread isn't running, so dropping is fine
+    commands_.push(effect);
+}
 
-        case SoundEffect::LevelUp:
-            // Ascending arpeggio
-            generateTone(261.63f, 0.1f, 0.3f);  // C4
-            generateTone(329.63f, 0.1f, 0.3f);  // E4
-            generateTone(392.00f, 0.1f, 0.3f);  // G4
-            generateTone(523.25f, 0.2f, 0.35f); // C5
-            break;
+void Sound::renderEffects() {
+    std::vector<float>& out = bank_;
+    out.clear();
+    for (size_t i = 0; i < EFFECT_COUNT; i++) {
+        effectRanges_[i].offset = static_cast<uint32_t>(out.size());
+
+        switch (static_cast<SoundEffect>(i)) {
+            case SoundEffect::Move:
+                // Short low click
+                generateTone(out, 200.0f, 0.05f, 0.2f);
+                break;
+
+            case SoundEffect::Rotate:
+                // Quick ascending tone
+                generateSweep(out, 300.0f, 500.0f, 0.08f, 0.25f);
+                break;
+
+            case SoundEffect::Drop:
+                // Thud sound - low frequency
+                generateTone(out, 100.0f, 0.1f, 0.4f);
+                generateTone(out, 80.0f, 0.1f, 0.3f);
+                break;
+
+            case SoundEffect::LineClear:
+                // Pleasant chime
+                generateTone(out, 523.25f, 0.1f, 0.3f);  // C5
+                generateTone(out, 659.25f, 0.1f, 0.3f);  // E5
+                generateTone(out, 783.99f, 0.15f, 0.3f); // G5
+                break;
+
+            case SoundEffect::Tetris:
+                // Triumphant fanfare for 4 lines
+                generateTone(out, 523.25f, 0.1f, 0.35f);  // C5
+                generateTone(out, 659.25f, 0.1f, 0.35f);  // E5
+                generateTone(out, 783.99f, 0.1f, 0.35f);  // G5
+                generateTone(out, 1046.50f, 0.2f, 0.4f);  // C6
+                break;
+
+            case SoundEffect::LevelUp:
+                // Ascending arpeggio
+                generateTone(out, 261.63f, 0.1f, 0.3f);  // C4
+                generateTone(out, 329.63f, 0.1f, 0.3f);  // E4
+                generateTone(out, 392.00f, 0.1f, 0.3f);  // G4
+                generateTone(out, 523.25f, 0.2f, 0.35f); // C5
+                break;
+
+            case SoundEffect::GameOver:
+                // Descending sad tones
+                generateTone(out, 400.0f, 0.2f, 0.3f);
+                generateTone(out, 300.0f, 0.2f, 0.3f);
+                generateTone(out, 200.0f, 0.3f, 0.25f);
+                generateTone(out, 150.0f, 0.4f, 0.2f);
+                break;
+
+            case SoundEffect::Count:
+                break;
+        }
 
-        case SoundEffect::GameOver:
-            // Descending sad tones
-            generateTone(400.0f, 0.2f, 0.3f);
-            generateTone(300.0f, 0.2f, 0.3f);
-            generateTone(200.0f, 0.3f, 0.25f);
-            generateTone(150.0f, 0.4f, 0.2f);
-            break;
+        effectRanges_[i].length = static_cast<uint32_t>(out.size()) - effectRanges_[i].offset;
     }
 }
@@ -1,10 +1,10 @@
 #pragma once
 
-#include <SDL.h>
+#include "SpscQueue.h"
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <vector>
-#include <queue>
-#include <mutex>
 
 enum class SoundEffect {
     Move,
@@ -13,30 +13,61 @@ enum class SoundEffect {
     LineClear,
     Tetris,     // 4 lines at once
     LevelUp,
-    GameOver
+    GameOver,
+    Count
 };
 
+// Procedural sound effects. Output goes through AudioEngine's effects bus.
 class Sound {
 public:
     Sound();
-    ~Sound();
 
-    bool init();
-    void shutdown();
+    // Re-renders every effect at sampleRate and silences all voices. Not
+    // safe while the audio thread is rendering.
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return sampleRate_; }
 
+    // Hands the effect to the audio thread without locking or allocating.
+    // Effects overlap, up to MAX_VOICES at once.
     void play(SoundEffect effect);
 
+    // Audio thread only. Starts any effects played since the last call and
+    // writes the sum of all playing voices to out.
+    void render(float* out, int samples);
+
+    static constexpr int MAX_VOICES = 16;
+    static constexpr int DEFAULT_SAMPLE_RATE = 44100;
+
 private:
-    static void audioCallback(void* userdata, Uint8* stream, int len);
-    void generateTone(float frequency, float duration, float volume = 0.3f);
-    void generateSweep(float startFreq, float endFreq, float duration, float volume = 0.3f);
+    // Takes a free voice, or the oldest one if all are busy
+    void startVoice(SoundEffect effect);
+
+    // Synthesises every effect once, up front
+    void renderEffects();
+    void generateTone(std::vector<float>& out, float frequency, float duration, float volume = 0.3f) const;
+    void generateSweep(std::vector<float>& out, float startFreq, float endFreq, float duration,
+                       float volume = 0.3f) const;
+
+    // Every effect back to back in one buffer, written before playback starts
+    struct EffectRange {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+    static constexpr size_t EFFECT_COUNT = static_cast<size_t>(SoundEffect::Count);
+    std::vector<float> bank_;
+    std::array<EffectRange, EFFECT_COUNT> effectRanges_;
 
-    SDL_AudioDeviceID audioDevice_ = 0;
-    SDL_AudioSpec audioSpec_;
+    // Play commands from the game thread to the audio callback
+    SpscQueue<SoundEffect, 64> commands_;
 
-    std::vector<float> audioBuffer_;
-    size_t bufferPosition_ = 0;
-    std::mutex bufferMutex_;
+    // Owned by the audio callback. A voice is idle when position == end.
+    struct Voice {
+        uint32_t position = 0;
+        uint32_t end = 0;
+        uint64_t started = 0;   // Trigger order, for stealing the oldest
+    };
+    std::array<Voice, MAX_VOICES> voices_;
+    uint64_t triggerCount_ = 0;
 
-    static constexpr int SAMPLE_RATE = 44100;
+    int sampleRate_ = DEFAULT_SAMPLE_RATE;
 };
@@ -3,7 +3,7 @@
 #include <array>
 #include <cstdint>
 
-enum class TetrominoType {
+enum class TetrominoType : uint8_t {
     I, O, T, S, Z, J, L,
     Count
 };
@@ -12,33 +12,152 @@ struct Color {
     uint8_t r, g, b;
 };
 
+// Precomputed data for one (type, rotation) pair.
+// Cells live in a 4x4 grid packed into 16 bits: bit (y * 4 + x).
+struct ShapeInfo {
+    uint16_t mask = 0;
+    // Bounding box of the filled cells within the 4x4 grid (inclusive)
+    int8_t minX = 0, maxX = 0;
+    int8_t minY = 0, maxY = 0;
+    // Lowest filled row of each column, -1 for empty columns
+    std::array<int8_t, 4> bottom = {-1, -1, -1, -1};
+};
+
+namespace shape_table {
+
+constexpr int SIZE = 4;
+constexpr int ROTATIONS = 4;
+constexpr int TYPES = static_cast<int>(TetrominoType::Count);
+
+// Builds a mask from 16 characters, row by row, where 'X' is a filled cell
+constexpr uint16_t maskFromRows(const char* rows) {
+    uint16_t mask = 0;
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        if (rows[i] == 'X') mask |= 1u << i;
+    }
+    return mask;
+}
+
+// Rotate 90 degrees clockwise: new[x][SIZE-1-y] = old[y][x]
+constexpr uint16_t rotateClockwise(uint16_t mask) {
+    uint16_t rotated = 0;
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            if (mask & (1u << (y * SIZE + x))) {
+                rotated |= 1u << (x * SIZE + (SIZE - 1 - y));
+            }
+        }
+    }
+    return rotated;
+}
+
+constexpr ShapeInfo makeShapeInfo(uint16_t mask) {
+    ShapeInfo info;
+    info.mask = mask;
+    info.minX = info.minY = SIZE;
+    info.maxX = info.maxY = -1;
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            if (!(mask & (1u << (y * SIZE + x)))) continue;
+            if (x < info.minX) info.minX = static_cast<int8_t>(x);
+            if (x > info.maxX) info.maxX = static_cast<int8_t>(x);
+            if (y < info.minY) info.minY = static_cast<int8_t>(y);
+            if (y > info.maxY) info.maxY = static_cast<int8_t>(y);
+            info.bottom[x] = static_cast<int8_t>(y);
+        }
+    }
+    return info;
+}
+
+using Table = std::array<std::array<ShapeInfo, ROTATIONS>, TYPES>;
+
+constexpr Table build() {
+    // Base shapes (rotation 0), indexed by TetrominoType
+    const uint16_t base[TYPES] = {
+        maskFromRows("...."
+                     "XXXX"
+                     "...."
+                     "...."), // I
+        maskFromRows("...."
+                     ".XX."
+                     ".XX."
+                     "...."), // O
+        maskFromRows("...."
+                     "XXX."
+                     ".X.."
+                     "...."), // T
+        maskFromRows("...."
+                     ".XX."
+                     "XX.."
+                     "...."), // S
+        maskFromRows("...."
+                     "XX.."
+                     ".XX."
+                     "...."), // Z
+        maskFromRows("...."
+                     "XXX."
+                     "..X."
+                     "...."), // J
+        maskFromRows("...."
+                     "XXX."
+                     "X..."
+                     "...."), // L
+    };
+
+    Table table{};
+    for (int type = 0; type < TYPES; type++) {
+        uint16_t mask = base[type];
+        for (int r = 0; r < ROTATIONS; r++) {
+            table[type][r] = makeShapeInfo(mask);
+            // O piece doesn't rotate (all rotations are the same)
+            if (type != static_cast<int>(TetrominoType::O)) {
+                mask = rotateClockwise(mask);
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr Table SHAPES = build();
+
+} // namespace shape_table
+
+// A piece is just its type, rotation and position; shapes come from the
+// compile-time table above, so copying or creating one is free.
 class Tetromino {
 public:
-    static constexpr int SIZE = 4;
-    using Shape = std::array<std::array<bool, SIZE>, SIZE>;
+    static constexpr int SIZE = shape_table::SIZE;
 
-    explicit Tetromino(TetrominoType type);
+    explicit Tetromino(TetrominoType type) : type_(type) {}
 
-    void rotateClockwise();
-    void rotateCounterClockwise();
+    void rotateClockwise() { rotation_ = (rotation_ + 1) & 3; }
+    void rotateCounterClockwise() { rotation_ = (rotation_ + 3) & 3; }
+
+    const ShapeInfo& getShape() const { return shapeFor(type_, rotation_); }
+    uint16_t getMask() const { return getShape().mask; }
+    bool isFilled(int x, int y) const { return (getMask() >> (y * SIZE + x)) & 1; }
 
-    const Shape& getShape() const { return shapes_[rotation_]; }
     TetrominoType getType() const { return type_; }
+    int getRotation() const { return rotation_; }
     Color getColor() const;
 
     int getX() const { return x_; }
     int getY() const { return y_; }
-    void setPosition(int x, int y) { x_ = x; y_ = y; }
-    void move(int dx, int dy) { x_ += dx; y_ += dy; }
+    void setPosition(int x, int y) { x_ = static_cast<int16_t>(x); y_ = static_cast<int16_t>(y); }
+    void move(int dx, int dy) { x_ = static_cast<int16_t>(x_ + dx); y_ = static_cast<int16_t>(y_ + dy); }
+
+    static const ShapeInfo& shapeFor(TetrominoType type, int rotation) {
+        return shape_table::SHAPES[static_cast<int>(type)][rotation];
+    }
+
+    // The 4 cells of one shape row, bit x is column x
+    static unsigned rowBits(uint16_t mask, int row) { return (mask >> (row * SIZE)) & 0xF; }
 
     static Color getColorForType(TetrominoType type);
 
 private:
-    void initShapes();
-
     TetrominoType type_;
-    int rotation_ = 0;
-    int x_ = 0;
-    int y_ = 0;
-    std::array<Shape, 4> shapes_;
+    uint8_t rotation_ = 0;
+    int16_t x_ = 0;
+    int16_t y_ = 0;
 };
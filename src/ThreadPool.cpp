@@ -0,0 +1,135 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace {
+
+constexpr uint64_t packRange(uint32_t begin, uint32_t end) {
+    return (static_cast<uint64_t>(end) << 32) | begin;
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned slots) {
+    if (slots == 0) {
+        slots = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    ranges_ = std::vector<Range>(slots);
+
+    for (unsigned slot = 1; slot < slots; slot++) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, slot);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, unsigned)>& fn) {
+    if (count == 0) return;
+
+    // Small loops or a single slot: no point waking anyone
+    if (workers_.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) {
+            fn(i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &fn;
+        unsigned slots = size();
+        for (unsigned slot = 0; slot < slots; slot++) {
+            ranges_[slot].bounds = packRange(static_cast<uint32_t>(count * slot / slots),
+                                             static_cast<uint32_t>(count * (slot + 1) / slots));
+        }
+        busyWorkers_ = static_cast<unsigned>(workers_.size());
+        generation_++;
+    }
+    wake_.notify_all();
+
+    runIndices(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busyWorkers_ == 0; });
+    job_ = nullptr;
+}
+
+void ThreadPool::runIndices(unsigned slot) {
+    size_t index;
+    do {
+        while (popOwn(slot, index)) {
+            (*job_)(index, slot);
+        }
+    } while (steal(slot));
+}
+
+bool ThreadPool::popOwn(unsigned slot, size_t& index) {
+    std::atomic<uint64_t>& bounds = ranges_[slot].bounds;
+    uint64_t current = bounds.load();
+
+    while (true) {
+        uint32_t begin = static_cast<uint32_t>(current);
+        uint32_t end = static_cast<uint32_t>(current >> 32);
+        if (begin >= end) return false;
+
+        if (bounds.compare_exchange_weak(current, packRange(begin + 1, end))) {
+            index = begin;
+            return true;
+        }
+    }
+}
+
+bool ThreadPool::steal(unsigned slot) {
+    unsigned slots = size();
+
+    for (unsigned offset = 1; offset < slots; offset++) {
+        std::atomic<uint64_t>& victim = ranges_[(slot + offset) % slots].bounds;
+        uint64_t current = victim.load();
+
+        while (true) {
+            uint32_t begin = static_cast<uint32_t>(current);
+            uint32_t end = static_cast<uint32_t>(current >> 32);
+            if (begin >= end) break;
+
+            // Take the back half, or the last index if only one is left
+            uint32_t middle = begin + (end - begin) / 2;
+            if (victim.compare_exchange_weak(current, packRange(begin, middle))) {
+                // Our own share is empty, so nobody else touches it meanwhile
+                ranges_[slot].bounds = packRange(middle, end);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned slot) {
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stopping_ || generation_ != seenGeneration; });
+            if (stopping_) return;
+            seenGeneration = generation_;
+        }
+
+        runIndices(slot);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busyWorkers_--;
+        }
+        done_.notify_one();
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. The calling thread
+// takes part in every loop, so a pool of N slots starts N - 1 threads.
+//
+// Each loop's index range is split evenly between the slots. A slot works
+// through its own share front to back, and once it runs dry it steals the
+// back half of another slot's remaining share, so loops whose iterations
+// differ wildly in cost still keep every core busy.
+class ThreadPool {
+public:
+    // 0 picks one slot per hardware thread
+    explicit ThreadPool(unsigned slots = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of threads that run loop bodies, including the caller
+    unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    // Runs fn(index, slot) for every index in [0, count) and returns once all
+    // are done. slot is in [0, size()) and unique among concurrent calls, so it
+    // can index per-thread scratch data.
+    void parallelFor(size_t count, const std::function<void(size_t, unsigned)>& fn);
+
+private:
+    void workerLoop(unsigned slot);
+    void runIndices(unsigned slot);
+    bool popOwn(unsigned slot, size_t& index);
+    bool steal(unsigned slot);
+
+    // Remaining [begin, end) of one slot's share, packed as end << 32 | begin
+    // so the owner and thieves can update it with a single compare-exchange
+    struct alignas(64) Range {
+        std::atomic<uint64_t> bounds{0};
+    };
+
+    std::vector<std::thread> workers_;
+    std::vector<Range> ranges_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    // Current loop, guarded by mutex_
+    const std::function<void(size_t, unsigned)>* job_ = nullptr;
+    uint64_t generation_ = 0;
+    unsigned busyWorkers_ = 0;
+    bool stopping_ = false;
+};
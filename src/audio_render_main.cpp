@@ -0,0 +1,236 @@
+#include "Mixer.h"
+#include "Music.h"
+#include "Sound.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Renders the game's audio without a device, as fast as the CPU allows:
+// the music plus any scripted sound effects, through the same mixer the
+// game uses, to a 32-bit float WAV file. The output is deterministic, so
+// the printed hash can be compared between builds.
+//
+// A script has one effect per line, "<time in ms> <effect>", e.g.
+//   0     Move
+//   1500  LineClear
+// Blank lines and lines starting with # are ignored.
+
+namespace {
+
+struct Options {
+    double seconds = 15.0;
+    int sampleRate = Music::DEFAULT_SAMPLE_RATE;
+    const char* scriptPath = nullptr;
+    const char* outPath = nullptr;
+    bool music = true;
+};
+
+struct Trigger {
+    uint64_t sample;
+    SoundEffect effect;
+};
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "Usage: %s --out <file.wav> [--seconds <s>] [--rate <hz>] [--script <file>] [--no-music]\n"
+        "  --out F       write mono 32-bit float WAV to F\n"
+        "  --seconds S   length to render (default 15, one loop of the music)\n"
+        "  --rate HZ     sample rate, resampled like a device at that rate would be (default %d)\n"
+        "  --script F    sound effects to trigger, one \"<ms> <effect>\" per line\n"
+        "  --no-music    render the effects alone\n"
+        "Effects: Move Rotate Drop LineClear Tetris LevelUp GameOver\n",
+        program, Music::DEFAULT_SAMPLE_RATE);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--no-music") == 0) {
+            options.music = false;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+
+        const char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--out") == 0) {
+            options.outPath = value;
+        } else if (std::strcmp(argv[i - 1], "--seconds") == 0) {
+            options.seconds = std::atof(value);
+        } else if (std::strcmp(argv[i - 1], "--rate") == 0) {
+            options.sampleRate = std::atoi(value);
+        } else if (std::strcmp(argv[i - 1], "--script") == 0) {
+            options.scriptPath = value;
+        } else {
+            return false;
+        }
+    }
+    return options.outPath && options.seconds > 0.0 && options.sampleRate > 0;
+}
+
+bool effectFromName(const std::string& name, SoundEffect& effect) {
+    static const std::pair<const char*, SoundEffect> names[] = {
+        {"Move", SoundEffect::Move},
+        {"Rotate", SoundEffect::Rotate},
+        {"Drop", SoundEffect::Drop},
+        {"LineClear", SoundEffect::LineClear},
+        {"Tetris", SoundEffect::Tetris},
+        {"LevelUp", SoundEffect::LevelUp},
+        {"GameOver", SoundEffect::GameOver},
+    };
+    for (const auto& [candidate, value] : names) {
+        if (name == candidate) {
+            effect = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool loadScript(const char* path, int sampleRate, std::vector<Trigger>& triggers) {
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "Cannot read script %s\n", path);
+        return false;
+    }
+
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); lineNumber++) {
+        std::istringstream fields(line);
+        double timeMs;
+        std::string name;
+        if (!(fields >> timeMs)) {
+            fields.clear();
+            if (!(fields >> name) || name[0] == '#') continue;
+            std::fprintf(stderr, "%s:%d: expected \"<ms> <effect>\"\n", path, lineNumber);
+            return false;
+        }
+
+        Trigger trigger;
+        if (!(fields >> name) || !effectFromName(name, trigger.effect) || timeMs < 0.0) {
+            std::fprintf(stderr, "%s:%d: expected \"<ms> <effect>\"\n", path, lineNumber);
+            return false;
+        }
+        trigger.sample = static_cast<uint64_t>(timeMs * sampleRate / 1000.0);
+        triggers.push_back(trigger);
+    }
+
+    std::stable_sort(triggers.begin(), triggers.end(),
+                     [](const Trigger& a, const Trigger& b) { return a.sample < b.sample; });
+    return true;
+}
+
+void putU16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+void putU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+// Mono IEEE float WAV, with the fact chunk non-PCM formats call for
+bool writeWav(const char* path, const std::vector<float>& samples, int sampleRate) {
+    uint32_t dataBytes = static_cast<uint32_t>(samples.size() * sizeof(float));
+
+    std::string header;
+    header += "RIFF";
+    putU32(header, 4 + (8 + 18) + (8 + 4) + (8 + dataBytes));
+    header += "WAVE";
+    header += "fmt ";
+    putU32(header, 18);
+    putU16(header, 3);                  // WAVE_FORMAT_IEEE_FLOAT
+    putU16(header, 1);                  // Channels
+    putU32(header, static_cast<uint32_t>(sampleRate));
+    putU32(header, static_cast<uint32_t>(sampleRate * sizeof(float)));
+    putU16(header, sizeof(float));      // Block align
+    putU16(header, 32);                 // Bits per sample
+    putU16(header, 0);                  // No extension
+    header += "fact";
+    putU32(header, 4);
+    putU32(header, static_cast<uint32_t>(samples.size()));
+    header += "data";
+    putU32(header, dataBytes);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.write(reinterpret_cast<const char*>(samples.data()), dataBytes);
+    return static_cast<bool>(file);
+}
+
+// FNV-1a over the raw sample bytes
+uint64_t hashSamples(const std::vector<float>& samples) {
+    uint64_t hash = 14695981039346656037ull;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(samples.data());
+    for (size_t i = 0; i < samples.size() * sizeof(float); i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Trigger> triggers;
+    if (options.scriptPath && !loadScript(options.scriptPath, options.sampleRate, triggers)) {
+        return 1;
+    }
+
+    Music music;
+    Sound sound;
+    Mixer mixer(music, sound);
+    mixer.setSampleRate(options.sampleRate);
+    if (options.music) {
+        music.play();
+    }
+
+    std::vector<float> samples(static_cast<size_t>(options.seconds * options.sampleRate));
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Render up to each trigger, so every effect starts on its exact sample
+    // (give or take one resampler input block when resampling)
+    uint64_t position = 0;
+    size_t nextTrigger = 0;
+    while (position < samples.size()) {
+        for (; nextTrigger < triggers.size() && triggers[nextTrigger].sample <= position; nextTrigger++) {
+            sound.play(triggers[nextTrigger].effect);
+        }
+
+        uint64_t end = samples.size();
+        if (nextTrigger < triggers.size()) {
+            end = std::min<uint64_t>(end, triggers[nextTrigger].sample);
+        }
+        end = std::min<uint64_t>(end, position + Mixer::BLOCK_SIZE);
+
+        mixer.render(samples.data() + position, static_cast<int>(end - position));
+        position = end;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!writeWav(options.outPath, samples, options.sampleRate)) {
+        std::fprintf(stderr, "Cannot write %s\n", options.outPath);
+        return 1;
+    }
+
+    double audioSeconds = static_cast<double>(samples.size()) / options.sampleRate;
+    std::printf("%zu samples (%.1f s at %d Hz%s), %zu effects, hash %016llx\n", samples.size(), audioSeconds,
+                options.sampleRate, mixer.resampling() ? ", resampled" : "", triggers.size(), static_cast<unsigned long long>(hashSamples(samples)));
+    std::printf("%.1f ms, %.0f samples/sec, %.0fx real time\n", seconds * 1000.0,
+                samples.size() / seconds, audioSeconds / seconds);
+    return 0;
+}
@@ -0,0 +1,387 @@
+#include "Board.h"
+#include "Bot.h"
+#include "Mixer.h"
+#include "MoveGenerator.h"
+#include "Music.h"
+#include "Simulation.h"
+#include "SoftwareRenderer.h"
+#include "Sound.h"
+#include "Tetromino.h"
+
+#ifdef TETRIS_BENCH_SDL
+#include "Game.h"
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Microbenchmarks for the engine, audio and render hot paths. Results are
+// written as JSON so runs can be compared for regressions.
+
+namespace {
+
+// Results are folded into this so the optimiser can't drop the work
+volatile uint64_t sink = 0;
+
+struct Options {
+    std::string filter;
+    double minSeconds = 0.5;
+    const char* outputPath = nullptr;
+};
+
+struct Result {
+    std::string name;
+    uint64_t iterations = 0;
+    double nsPerOp = 0.0;
+    double cpuNsPerOp = 0.0;
+    // Audio benchmarks also report how many samples one CPU-second renders
+    double samplesPerCpuSecond = 0.0;
+};
+
+class Runner {
+public:
+    explicit Runner(const Options& options) : options_(options) {}
+
+    // Times op, which performs `batch` operations per call, until at least
+    // minSeconds of wall time has passed
+    void run(const std::string& name, uint64_t batch, const std::function<void()>& op,
+             double samplesPerOp = 0.0) {
+        if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) {
+            return;
+        }
+
+        op(); // Warm up caches and lazy initialisation
+
+        uint64_t calls = 0;
+        auto wallStart = std::chrono::steady_clock::now();
+        std::clock_t cpuStart = std::clock();
+        double elapsed = 0.0;
+
+        while (elapsed < options_.minSeconds) {
+            // Grow the number of calls between clock reads as we go
+            uint64_t chunk = calls == 0 ? 1 : calls;
+            for (uint64_t i = 0; i < chunk; i++) {
+                op();
+            }
+            calls += chunk;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+        }
+
+        double cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+        Result result;
+        result.name = name;
+        result.iterations = calls * batch;
+        result.nsPerOp = elapsed * 1e9 / result.iterations;
+        result.cpuNsPerOp = cpuSeconds * 1e9 / result.iterations;
+        if (samplesPerOp > 0.0 && cpuSeconds > 0.0) {
+            result.samplesPerCpuSecond = samplesPerOp * result.iterations / cpuSeconds;
+        }
+        results_.push_back(result);
+
+        std::fprintf(stderr, "%-40s %12.1f ns/op\n", name.c_str(), result.nsPerOp);
+    }
+
+    void writeJson(std::FILE* out) const {
+        std::fprintf(out, "{\n  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results_.size(); i++) {
+            const Result& r = results_[i];
+            std::fprintf(out,
+                "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, \"cpu_ns_per_op\": %.3f",
+                r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.nsPerOp, r.cpuNsPerOp);
+            if (r.samplesPerCpuSecond > 0.0) {
+                std::fprintf(out, ", \"samples_per_cpu_second\": %.0f", r.samplesPerCpuSecond);
+            }
+            std::fprintf(out, "}%s\n", i + 1 < results_.size() ? "," : "");
+        }
+        std::fprintf(out, "  ]\n}\n");
+    }
+
+private:
+    Options options_;
+    std::vector<Result> results_;
+};
+
+// Board states from a bot game, sampled every few pieces, so stack heights,
+// holes and piece mixes look like real play
+struct Fixture {
+    std::vector<Board> boards;
+    std::vector<Tetromino> probes;      // Arbitrary positions, mostly colliding or out of bounds
+    std::vector<Tetromino> placements;  // Resting positions that are valid on the matching board
+    std::vector<Board> fullRowBoards;   // Boards where the placement completes at least one row
+    std::vector<Tetromino> fullRowPlacements;
+};
+
+Fixture buildFixture() {
+    Fixture fixture;
+    std::mt19937 rng(1234);
+    MoveGenerator generator;
+
+    Simulation simulation(42);
+    Bot bot;
+    while (fixture.boards.size() < 256) {
+        if (simulation.isGameOver()) simulation.reset(rng());
+
+        // A few random placements between bot moves keep the stack rough
+        const std::vector<Placement>& placements = generator.generate(simulation.board(), simulation.currentPiece());
+        if (!placements.empty()) {
+            const Placement& placement = placements[rng() % placements.size()];
+            fixture.boards.push_back(simulation.board());
+            fixture.placements.push_back(placement.piece);
+
+            Board after = simulation.board();
+            after.placePiece(placement.piece);
+            if (after.clearLines() > 0) {
+                fixture.fullRowBoards.push_back(simulation.board());
+                fixture.fullRowPlacements.push_back(placement.piece);
+            }
+        }
+
+        if (rng() % 4 == 0 && !placements.empty()) {
+            for (Input input : generator.pathTo(placements[rng() % placements.size()])) {
+                simulation.step(input, 0);
+            }
+        } else {
+            bot.update(simulation);
+        }
+    }
+
+    for (int i = 0; i < 1024; i++) {
+        Tetromino probe(static_cast<TetrominoType>(rng() % static_cast<int>(TetrominoType::Count)));
+        for (unsigned r = rng() % 4; r > 0; r--) probe.rotateClockwise();
+        probe.setPosition(static_cast<int>(rng() % (Board::WIDTH + 3)) - 3,
+                          static_cast<int>(rng() % (Board::HEIGHT + 2)) - 2);
+        fixture.probes.push_back(probe);
+    }
+
+    return fixture;
+}
+
+void benchEngine(Runner& runner) {
+    Fixture fixture = buildFixture();
+    const size_t boardCount = fixture.boards.size();
+
+    size_t i = 0;
+    runner.run("board/isValidPosition", 1, [&] {
+        i++;
+        sink += fixture.boards[i % boardCount].isValidPosition(fixture.probes[i % fixture.probes.size()]);
+    });
+
+    runner.run("board/copy", 1, [&] {
+        i++;
+        Board board = fixture.boards[i % boardCount];
+        sink += board.getRow(Board::HEIGHT - 1);
+    });
+
+    runner.run("board/placePiece (incl. copy)", 1, [&] {
+        i++;
+        Board board = fixture.boards[i % boardCount];
+        board.placePiece(fixture.placements[i % boardCount]);
+        sink += board.getRow(Board::HEIGHT - 1);
+    });
+
+    runner.run("board/clearLines (no full rows)", 1, [&] {
+        i++;
+        sink += fixture.boards[i % boardCount].clearLines();
+    });
+
+    if (!fixture.fullRowBoards.empty()) {
+        const size_t fullCount = fixture.fullRowBoards.size();
+        runner.run("board/clearLines (incl. copy + place)", 1, [&] {
+            i++;
+            Board board = fixture.fullRowBoards[i % fullCount];
+            board.placePiece(fixture.fullRowPlacements[i % fullCount]);
+            sink += board.clearLines();
+        });
+    }
+
+    runner.run("tetromino/construct", 1, [&] {
+        i++;
+        Tetromino piece(static_cast<TetrominoType>(i % static_cast<int>(TetrominoType::Count)));
+        sink += piece.getMask();
+    });
+
+    Tetromino rotating(TetrominoType::T);
+    runner.run("tetromino/rotateClockwise", 1, [&] {
+        rotating.rotateClockwise();
+        sink += rotating.getMask();
+    });
+
+    MoveGenerator generator;
+    runner.run("movegen/generate", 1, [&] {
+        i++;
+        const Tetromino& piece = fixture.placements[i % boardCount];
+        Tetromino spawn(piece.getType());
+        spawn.setPosition(Board::WIDTH / 2 - 2, 0);
+        sink += generator.generate(fixture.boards[i % boardCount], spawn).size();
+    });
+}
+
+void benchSoftwareRender(Runner& runner) {
+    Fixture fixture = buildFixture();
+    const size_t boardCount = fixture.boards.size();
+
+    SoftwareRenderer renderer;
+    size_t i = 0;
+    runner.run("softrender/frame", 1, [&] {
+        i++;
+        renderer.clear();
+        renderer.drawBoard(fixture.boards[i % boardCount]);
+        renderer.drawPiece(fixture.probes[i % fixture.probes.size()]);
+        renderer.drawNextPiece(fixture.placements[i % boardCount]);
+        renderer.drawStats(static_cast<int>(i * 40), 12, 115, static_cast<int>(i % 3600));
+        sink += renderer.pixel(SoftwareRenderer::WIDTH / 2, SoftwareRenderer::HEIGHT / 2);
+    });
+
+    runner.run("softrender/drawGameOver", 1, [&] {
+        renderer.drawGameOver();
+        sink += renderer.pixel(SoftwareRenderer::WIDTH / 2, SoftwareRenderer::HEIGHT / 2);
+    });
+}
+
+void benchAudio(Runner& runner) {
+    constexpr int SAMPLE_RATE = 44100;
+
+    Music music;
+    std::vector<float> buffer(SAMPLE_RATE);
+    runner.run("music/render (1 s of audio)", 1, [&] {
+        music.render(buffer.data(), SAMPLE_RATE);
+        sink += static_cast<uint64_t>(buffer[SAMPLE_RATE / 2] * 1000.0f);
+    }, SAMPLE_RATE);
+
+    // Playback from a pre-rendered loop, as with tetris --music-cache
+    std::vector<float> loop(Music::loopSamples(SAMPLE_RATE) + Music::loopCrossfadeSamples(SAMPLE_RATE));
+    Music source;
+    source.setVolume(1.0f);
+    source.render(loop.data(), static_cast<int>(loop.size()));
+    Music looped;
+    looped.setLoop(loop.data());
+    runner.run("music/render from loop (1 s of audio)", 1, [&] {
+        looped.render(buffer.data(), SAMPLE_RATE);
+        sink += static_cast<uint64_t>(buffer[SAMPLE_RATE / 2] * 1000.0f);
+    }, SAMPLE_RATE);
+
+    // Each trigger is followed by one mixer block, so this covers taking the
+    // play command and mixing the voices it starts
+    Sound sound;
+    std::vector<float> block(Mixer::BLOCK_SIZE);
+    static const std::pair<const char*, SoundEffect> effects[] = {
+        {"Move", SoundEffect::Move},
+        {"Rotate", SoundEffect::Rotate},
+        {"Drop", SoundEffect::Drop},
+        {"LineClear", SoundEffect::LineClear},
+        {"Tetris", SoundEffect::Tetris},
+        {"LevelUp", SoundEffect::LevelUp},
+        {"GameOver", SoundEffect::GameOver},
+    };
+    for (const auto& [name, effect] : effects) {
+        runner.run(std::string("sound/play/") + name, 1, [&, effect = effect] {
+            sound.play(effect);
+            sound.render(block.data(), Mixer::BLOCK_SIZE);
+            sink += static_cast<uint64_t>(block[0] * 1000.0f);
+        });
+    }
+
+    // Full graph with music playing and a new effect every block
+    Mixer mixer(music, sound);
+    music.play();
+    runner.run("mixer/render (1 s of audio)", 1, [&] {
+        for (int done = 0; done < SAMPLE_RATE; done += Mixer::BLOCK_SIZE) {
+            sound.play(effects[(done / Mixer::BLOCK_SIZE) % 7].second);
+            mixer.render(buffer.data() + done, std::min(Mixer::BLOCK_SIZE, SAMPLE_RATE - done));
+        }
+        sink += static_cast<uint64_t>(buffer[SAMPLE_RATE / 2] * 1000.0f);
+    }, SAMPLE_RATE);
+
+    // A device rate outside the native range: synthesis at 44100 Hz plus
+    // the polyphase resampler
+    constexpr int RESAMPLED_RATE = 96000;
+    std::vector<float> resampled(RESAMPLED_RATE);
+    mixer.setSampleRate(RESAMPLED_RATE);
+    runner.run("mixer/render at 96 kHz, resampled (1 s of audio)", 1, [&] {
+        mixer.render(resampled.data(), RESAMPLED_RATE);
+        sink += static_cast<uint64_t>(resampled[RESAMPLED_RATE / 2] * 1000.0f);
+    }, RESAMPLED_RATE);
+}
+
+#ifdef TETRIS_BENCH_SDL
+
+void benchRender(Runner& runner) {
+    // Render off screen with SDL's software renderer so results don't
+    // depend on a display or GPU driver
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+
+    Game game(42);
+    game.setBot(false, 0.0);
+    game.setFramePacing(false, 0.0);
+    if (!game.init()) {
+        std::fprintf(stderr, "game/render skipped: SDL init failed\n");
+        return;
+    }
+
+    runner.run("game/render", 1, [&] {
+        game.render();
+    });
+
+    game.shutdown();
+}
+
+#endif
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "Usage: %s [--filter <substring>] [--min-time <seconds>] [--out <file.json>]\n"
+        "Writes JSON results to stdout unless --out is given.\n",
+        program);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            options.minSeconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            options.outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    Runner runner(options);
+
+    benchEngine(runner);
+    benchSoftwareRender(runner);
+    benchAudio(runner);
+#ifdef TETRIS_BENCH_SDL
+    benchRender(runner);
+#endif
+
+    std::FILE* out = stdout;
+    if (options.outputPath) {
+        out = std::fopen(options.outputPath, "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot write %s\n", options.outputPath);
+            return 1;
+        }
+    }
+    runner.writeJson(out);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+
+    return 0;
+}
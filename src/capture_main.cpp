@@ -0,0 +1,168 @@
+#include "Bot.h"
+#include "Replay.h"
+#include "Simulation.h"
+#include "SoftwareRenderer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Renders a replay or a seeded bot game to frames with the software
+// renderer, without a window. Raw frames can be piped straight into an
+// encoder:
+//   tetris_capture --seed 7 --raw - |
+//       ffmpeg -f rawvideo -pix_fmt bgra -s 490x640 -r 30 -i - game.mp4
+
+namespace {
+
+struct Options {
+    const char* replayPath = nullptr;
+    uint32_t seed = 1;
+    double botPiecesPerSecond = 3.0;
+    double maxSeconds = 60.0;   // Bot games only, replays run to their end
+    int fps = 30;
+    const char* rawPath = nullptr;
+    const char* ppmPrefix = nullptr;
+};
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "Usage: %s [--replay <file.trp> | --seed <n> [--bot-pps <n>] [--max-seconds <s>]]\n"
+        "          [--fps <n>] (--raw <file or -> | --ppm <prefix>)\n"
+        "  --replay F       render a recorded game\n"
+        "  --seed N         render a bot game with this seed (default 1)\n"
+        "  --bot-pps N      bot speed in pieces per second (default 3)\n"
+        "  --max-seconds S  stop a bot game after S seconds, 0 = until top out (default 60)\n"
+        "  --fps N          frames per second of game time (default 30)\n"
+        "  --raw F          write raw %dx%d BGRA frames to F, - for stdout\n"
+        "  --ppm P          write each frame to P-000000.ppm, P-000001.ppm, ...\n",
+        program, SoftwareRenderer::WIDTH, SoftwareRenderer::HEIGHT);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) return false;
+
+        const char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--replay") == 0) {
+            options.replayPath = value;
+        } else if (std::strcmp(argv[i - 1], "--seed") == 0) {
+            options.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(argv[i - 1], "--bot-pps") == 0) {
+            options.botPiecesPerSecond = std::atof(value);
+        } else if (std::strcmp(argv[i - 1], "--max-seconds") == 0) {
+            options.maxSeconds = std::atof(value);
+        } else if (std::strcmp(argv[i - 1], "--fps") == 0) {
+            options.fps = std::atoi(value);
+        } else if (std::strcmp(argv[i - 1], "--raw") == 0) {
+            options.rawPath = value;
+        } else if (std::strcmp(argv[i - 1], "--ppm") == 0) {
+            options.ppmPrefix = value;
+        } else {
+            return false;
+        }
+    }
+    return options.fps > 0 && (options.rawPath || options.ppmPrefix);
+}
+
+void renderFrame(SoftwareRenderer& renderer, const Simulation& simulation) {
+    renderer.clear();
+    renderer.drawBoard(simulation.board());
+    if (!simulation.isGameOver()) {
+        renderer.drawPiece(simulation.currentPiece());
+    }
+    renderer.drawNextPiece(simulation.nextPiece());
+    renderer.drawStats(simulation.score(), simulation.level(), simulation.totalLines(),
+                       static_cast<int>(simulation.elapsedMs() / 1000));
+    if (simulation.isGameOver()) {
+        renderer.drawGameOver();
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Replay replay;
+    if (options.replayPath && !Replay::load(options.replayPath, replay)) {
+        std::fprintf(stderr, "Cannot read replay %s\n", options.replayPath);
+        return 1;
+    }
+
+    std::FILE* raw = nullptr;
+    if (options.rawPath) {
+        raw = std::strcmp(options.rawPath, "-") == 0 ? stdout : std::fopen(options.rawPath, "wb");
+        if (!raw) {
+            std::fprintf(stderr, "Cannot write %s\n", options.rawPath);
+            return 1;
+        }
+    }
+
+    Simulation simulation(options.replayPath ? replay.seed() : options.seed);
+    Bot bot;
+    bot.setPiecesPerSecond(options.botPiecesPerSecond);
+
+    SoftwareRenderer renderer;
+    size_t nextEntry = 0;
+    uint64_t endMs = options.replayPath ? replay.outcome().endTimeMs
+                                        : static_cast<uint64_t>(options.maxSeconds * 1000.0);
+
+    double renderSeconds = 0.0;
+    int frames = 0;
+    for (bool done = false; !done; frames++) {
+        // Frame times are derived from the frame number so they never drift
+        uint64_t frameMs = static_cast<uint64_t>(frames) * 1000 / options.fps;
+
+        if (options.replayPath) {
+            const std::vector<Replay::Entry>& entries = replay.entries();
+            for (; nextEntry < entries.size() && entries[nextEntry].timeMs <= frameMs; nextEntry++) {
+                simulation.step(Input::None, static_cast<uint32_t>(entries[nextEntry].timeMs - simulation.elapsedMs()));
+                simulation.step(entries[nextEntry].input, 0);
+            }
+            done = frameMs >= endMs;
+            frameMs = std::min(frameMs, endMs);
+        } else {
+            bot.update(simulation);
+            done = simulation.isGameOver() || (endMs > 0 && frameMs >= endMs);
+        }
+        if (frameMs > simulation.elapsedMs()) {
+            simulation.step(Input::None, static_cast<uint32_t>(frameMs - simulation.elapsedMs()));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        renderFrame(renderer, simulation);
+        renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (raw && !renderer.writeRaw(raw)) {
+            std::fprintf(stderr, "Write failed after %d frames\n", frames);
+            return 1;
+        }
+        if (options.ppmPrefix) {
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), "-%06d.ppm", frames);
+            std::string path = std::string(options.ppmPrefix) + suffix;
+            if (!renderer.writePpm(path)) {
+                std::fprintf(stderr, "Cannot write %s\n", path.c_str());
+                return 1;
+            }
+        }
+    }
+
+    if (raw && raw != stdout) {
+        std::fclose(raw);
+    } else if (raw) {
+        std::fflush(raw);
+    }
+
+    std::fprintf(stderr, "%d frames, score %d, lines %d, %.1f us per frame rendered\n",
+                 frames, simulation.score(), simulation.totalLines(), renderSeconds * 1e6 / frames);
+    return 0;
+}
@@ -1,11 +1,61 @@
 #include "Game.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <random>
 
 int main(int argc, char* argv[]) {
-    (void)argc;
-    (void)argv;
-
-    Game game;
+    uint32_t seed = std::random_device{}();
+    bool bot = false;
+    double botPiecesPerSecond = Game::DEFAULT_BOT_PPS;
+    const char* replayPrefix = nullptr;
+    bool vsync = true;
+    double maxFps = Game::DEFAULT_MAX_FPS;
+    bool perfHud = false;
+    const char* perfLog = nullptr;
+    const char* musicCache = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--bot") == 0) {
+            bot = true;
+        } else if (std::strcmp(argv[i], "--bot-pps") == 0 && i + 1 < argc) {
+            bot = true;
+            botPiecesPerSecond = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            replayPrefix = argv[++i];
+        } else if (std::strcmp(argv[i], "--no-vsync") == 0) {
+            vsync = false;
+        } else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            maxFps = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--perf-hud") == 0) {
+            perfHud = true;
+        } else if (std::strcmp(argv[i], "--perf-log") == 0 && i + 1 < argc) {
+            perfLog = argv[++i];
+        } else if (std::strcmp(argv[i], "--music-cache") == 0 && i + 1 < argc) {
+            musicCache = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--seed <n>] [--bot] [--bot-pps <pieces per second, 0 = uncapped>]"
+                      << " [--record <replay prefix>] [--no-vsync] [--fps <frame cap, 0 = uncapped>]"
+                      << " [--perf-hud] [--perf-log <file.csv>] [--music-cache <file>]" << std::endl;
+            return 1;
+        }
+    }
+    Game game(seed);
+    game.setBot(bot, botPiecesPerSecond);
+    game.setFramePacing(vsync, maxFps);
+    game.setPerfHud(perfHud);
+    if (perfLog && !game.setPerfLog(perfLog)) {
+        std::cerr << "Failed to open " << perfLog << std::endl;
+        return 1;
+    }
+    if (replayPrefix) {
+        game.setReplayPrefix(replayPrefix);
+    }
+    if (musicCache) {
+        game.setMusicCache(musicCache);
+    }
 
     if (!game.init()) {
         std::cerr << "Failed to initialize game" << std::endl;
@@ -0,0 +1,142 @@
+#include "Replay.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Re-simulates recorded replays with no rendering or frame pacing and checks
+// that each one still reaches the score, lines and piece count it recorded.
+// Exits non-zero if any replay fails to load or diverges, so a directory of
+// replays doubles as a regression suite for rule changes.
+
+namespace {
+
+struct Options {
+    unsigned threads = 0;   // 0 = one per hardware thread
+    int repeat = 1;         // Verify every replay this many times, for timing
+    bool verbose = false;
+    std::vector<std::string> paths;
+};
+
+enum class Status {
+    Ok,
+    LoadFailed,
+    Mismatch
+};
+
+struct FileResult {
+    Status status = Status::Ok;
+    ReplayOutcome expected;
+    ReplayOutcome actual;
+    size_t inputs = 0;
+};
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "Usage: %s [--threads T] [--repeat N] [--verbose] <replay.trp>...\n"
+        "  --threads T  worker threads, 0 = all cores (default 0)\n"
+        "  --repeat N   verify each replay N times, for throughput measurement (default 1)\n"
+        "  --verbose    print every replay, not just failures\n",
+        program);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            options.repeat = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--verbose") == 0) {
+            options.verbose = true;
+        } else if (argv[i][0] == '-') {
+            return false;
+        } else {
+            options.paths.push_back(argv[i]);
+        }
+    }
+    return !options.paths.empty() && options.repeat > 0;
+}
+
+void printOutcome(const char* label, const ReplayOutcome& outcome) {
+    std::printf("  %-9s score %d, lines %d, pieces %d, time %llu ms\n", label,
+                outcome.score, outcome.lines, outcome.pieces,
+                static_cast<unsigned long long>(outcome.endTimeMs));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Load up front so file I/O stays out of the timing
+    std::vector<Replay> replays(options.paths.size());
+    std::vector<FileResult> results(options.paths.size());
+    for (size_t i = 0; i < options.paths.size(); i++) {
+        if (!Replay::load(options.paths[i], replays[i])) {
+            results[i].status = Status::LoadFailed;
+        }
+        results[i].expected = replays[i].outcome();
+        results[i].inputs = replays[i].entries().size();
+    }
+
+    ThreadPool pool(options.threads);
+    size_t jobs = replays.size() * static_cast<size_t>(options.repeat);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Every job writes its own slot, so no two threads share an outcome.
+    // Repeats only add load; the first pass over the files is what gets
+    // checked.
+    std::vector<ReplayOutcome> outcomes(jobs);
+    pool.parallelFor(jobs, [&](size_t job, unsigned) {
+        size_t index = job % replays.size();
+        if (results[index].status != Status::LoadFailed) {
+            outcomes[job] = replays[index].simulate();
+        }
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int failures = 0;
+    uint64_t totalInputs = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        FileResult& result = results[i];
+        totalInputs += result.inputs;
+
+        if (result.status == Status::LoadFailed) {
+            std::printf("FAIL %s: not a valid replay file\n", options.paths[i].c_str());
+            failures++;
+            continue;
+        }
+
+        result.actual = outcomes[i];
+        if (result.actual != result.expected) {
+            result.status = Status::Mismatch;
+            failures++;
+        }
+
+        if (result.status == Status::Mismatch || options.verbose) {
+            std::printf("%s %s (seed %u, %zu inputs)\n", result.status == Status::Ok ? "ok  " : "FAIL",
+                        options.paths[i].c_str(), replays[i].seed(), result.inputs);
+        }
+        if (result.status == Status::Mismatch) {
+            printOutcome("recorded", result.expected);
+            printOutcome("replayed", result.actual);
+        }
+    }
+
+    std::printf("%zu replays, %d failed\n", results.size(), failures);
+    std::printf("verified %zu replays (%llu inputs) in %.3f s on %u threads: %.0f replays/sec\n",
+                jobs, static_cast<unsigned long long>(totalInputs * options.repeat), seconds, pool.size(),
+                jobs / seconds);
+
+    return failures == 0 ? 0 : 1;
+}
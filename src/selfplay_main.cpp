@@ -0,0 +1,166 @@
+#include "Bot.h"
+#include "Replay.h"
+#include "Simulation.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Runs many independent bot games across all cores and reports aggregate
+// statistics. Game i is seeded with seed + i, so any game can be rerun alone.
+
+namespace {
+
+struct Options {
+    int games = 100;
+    uint32_t seed = 1;
+    unsigned threads = 0;     // 0 = one per hardware thread
+    int maxPieces = 10000;    // The bot rarely tops out, so cap game length; 0 = no cap
+    double botPiecesPerSecond = 3.0; // Simulation time between pieces, so gravity and level speed apply
+    std::string recordPrefix; // Save each game to <prefix>-<seed>.trp when set
+};
+
+struct GameResult {
+    int score = 0;
+    int lines = 0;
+    int pieces = 0;
+    bool toppedOut = false;
+};
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+        "Usage: %s [--games N] [--seed S] [--threads T] [--max-pieces P] [--bot-pps N] [--record PREFIX]\n"
+        "  --games N       number of games to play (default 100)\n"
+        "  --seed S        seed of the first game, game i uses S + i (default 1)\n"
+        "  --threads T     worker threads, 0 = all cores (default 0)\n"
+        "  --max-pieces P  end a game after P pieces, 0 = play until top out (default 10000)\n"
+        "  --bot-pps N     bot speed in pieces per second of game time (default 3)\n"
+        "  --record PREFIX save a replay of each game to PREFIX-<seed>.trp\n",
+        program);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) return false;
+
+        const char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--games") == 0) {
+            options.games = std::atoi(value);
+        } else if (std::strcmp(argv[i - 1], "--seed") == 0) {
+            options.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(argv[i - 1], "--threads") == 0) {
+            options.threads = static_cast<unsigned>(std::atoi(value));
+        } else if (std::strcmp(argv[i - 1], "--max-pieces") == 0) {
+            options.maxPieces = std::atoi(value);
+        } else if (std::strcmp(argv[i - 1], "--bot-pps") == 0) {
+            options.botPiecesPerSecond = std::atof(value);
+        } else if (std::strcmp(argv[i - 1], "--record") == 0) {
+            options.recordPrefix = value;
+        } else {
+            return false;
+        }
+    }
+    return options.games > 0 && options.maxPieces >= 0 && options.botPiecesPerSecond > 0.0;
+}
+
+GameResult playGame(uint32_t seed, const Options& options) {
+    Simulation simulation(seed);
+    Bot bot; // Single-threaded, the pool parallelises across games instead
+    bot.setPiecesPerSecond(options.botPiecesPerSecond);
+    uint32_t pieceIntervalMs = static_cast<uint32_t>(1000.0 / options.botPiecesPerSecond);
+
+    Replay replay(seed);
+    if (!options.recordPrefix.empty()) {
+        simulation.setRecorder(&replay);
+    }
+
+    int maxPieces = options.maxPieces;
+    while (!simulation.isGameOver() && (maxPieces == 0 || simulation.piecesPlaced() < maxPieces)) {
+        // The next piece falls under gravity until the bot's turn comes round
+        bot.update(simulation);
+        simulation.step(Input::None, pieceIntervalMs);
+    }
+
+    if (!options.recordPrefix.empty()) {
+        replay.finish(simulation);
+        std::string path = options.recordPrefix + "-" + std::to_string(seed) + ".trp";
+        if (!replay.save(path)) {
+            std::fprintf(stderr, "Failed to save replay to %s\n", path.c_str());
+        }
+    }
+
+    GameResult result;
+    result.score = simulation.score();
+    result.lines = simulation.totalLines();
+    result.pieces = simulation.piecesPlaced();
+    result.toppedOut = simulation.isGameOver();
+    return result;
+}
+
+int percentile(const std::vector<int>& sorted, double p) {
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+// Mean, percentiles and range of one per-game metric
+void printDistribution(const char* name, std::vector<int> values) {
+    std::sort(values.begin(), values.end());
+    int64_t total = 0;
+    for (int value : values) {
+        total += value;
+    }
+    std::printf("%-7s mean %.1f, p50/p90/p99 %d / %d / %d, min/max %d / %d\n", name,
+                static_cast<double>(total) / values.size(), percentile(values, 0.50), percentile(values, 0.90),
+                percentile(values, 0.99), values.front(), values.back());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    ThreadPool pool(options.threads);
+    std::vector<GameResult> results(options.games);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Game lengths vary by orders of magnitude; the pool's work stealing
+    // keeps every thread busy until the last game finishes
+    pool.parallelFor(results.size(), [&](size_t index, unsigned) {
+        results[index] = playGame(options.seed + static_cast<uint32_t>(index), options);
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<int> scores, lines, pieces;
+    int64_t totalPieces = 0;
+    int toppedOut = 0;
+    for (const GameResult& result : results) {
+        scores.push_back(result.score);
+        lines.push_back(result.lines);
+        pieces.push_back(result.pieces);
+        totalPieces += result.pieces;
+        toppedOut += result.toppedOut;
+    }
+
+    int games = options.games;
+    std::printf("games          %d (%d topped out) on %u threads\n", games, toppedOut, pool.size());
+    printDistribution("score", scores);
+    printDistribution("lines", lines);
+    printDistribution("pieces", pieces);
+    std::printf("pieces total   %lld\n", static_cast<long long>(totalPieces));
+    std::printf("elapsed        %.3f s\n", seconds);
+    std::printf("games/sec      %.2f\n", games / seconds);
+    std::printf("pieces/sec     %.0f\n", totalPieces / seconds);
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "Board.h"
+#include "SoftwareRenderer.h"
+#include "Tetromino.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// Golden-image tests for the software renderer: fixed boards, pieces and
+// stats are drawn and the framebuffer hash compared with a reference.
+// The kernels are pixel-exact across SSE2, AVX2 and scalar builds, so a
+// changed hash means a changed picture. On a mismatch the frame is written
+// to <scene>.actual.ppm for inspection; run with --update to print the
+// current hashes for pasting below once a change is intended.
+
+namespace {
+
+// The references are for the default 10x20 playfield
+constexpr bool DEFAULT_BOARD = Board::WIDTH == 10 && Board::HEIGHT == 20;
+constexpr int SKIPPED = 77;
+
+struct Scene {
+    const char* name;
+    uint64_t expected;
+    void (*draw)(SoftwareRenderer& renderer);
+};
+
+// FNV-1a over the pixel words
+uint64_t hashPixels(const SoftwareRenderer& renderer) {
+    uint64_t hash = 14695981039346656037ull;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(renderer.pixels());
+    size_t size = static_cast<size_t>(SoftwareRenderer::WIDTH) * SoftwareRenderer::HEIGHT * sizeof(uint32_t);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+Tetromino pieceAt(TetrominoType type, int rotation, int x, int y) {
+    Tetromino piece(type);
+    for (int i = 0; i < rotation; i++) {
+        piece.rotateClockwise();
+    }
+    piece.setPosition(x, y);
+    return piece;
+}
+
+// A stack using every piece type and rotation, with holes and a ragged top
+Board stackedBoard() {
+    Board board;
+    board.placePiece(pieceAt(TetrominoType::I, 0, 0, 17));
+    board.placePiece(pieceAt(TetrominoType::O, 0, 3, 17));
+    board.placePiece(pieceAt(TetrominoType::T, 2, 5, 16));
+    board.placePiece(pieceAt(TetrominoType::S, 0, 0, 15));
+    board.placePiece(pieceAt(TetrominoType::Z, 1, 6, 14));
+    board.placePiece(pieceAt(TetrominoType::J, 3, 2, 13));
+    board.placePiece(pieceAt(TetrominoType::L, 1, 7, 11));
+    return board;
+}
+
+void drawEmpty(SoftwareRenderer& renderer) {
+    renderer.clear();
+    renderer.drawBoard(Board());
+    renderer.drawStats(0, 1, 0, 0);
+}
+
+void drawStacked(SoftwareRenderer& renderer) {
+    renderer.clear();
+    renderer.drawBoard(stackedBoard());
+    renderer.drawStats(123456, 7, 63, 3725);
+}
+
+void drawPlaying(SoftwareRenderer& renderer) {
+    renderer.clear();
+    renderer.drawBoard(stackedBoard());
+    renderer.drawPiece(pieceAt(TetrominoType::T, 1, 4, 2), 13);
+    renderer.drawNextPiece(Tetromino(TetrominoType::I));
+    renderer.drawStats(9876543, 15, 149, 59);
+}
+
+void drawGameOver(SoftwareRenderer& renderer) {
+    drawStacked(renderer);
+    renderer.drawGameOver();
+}
+
+Scene scenes[] = {
+    {"empty", 0x4dca1b273ee9617dull, drawEmpty},
+    {"stacked", 0x962e7c2852349a5dull, drawStacked},
+    {"playing", 0x6b324eaa976b0bcdull, drawPlaying},
+    {"game_over", 0x60efc97c391cdd47ull, drawGameOver},
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool update = argc > 1 && std::strcmp(argv[1], "--update") == 0;
+    if (!DEFAULT_BOARD && !update) {
+        std::printf("Skipped: reference images are for a 10x20 board\n");
+        return SKIPPED;
+    }
+
+    SoftwareRenderer renderer;
+    int failures = 0;
+    for (const Scene& scene : scenes) {
+        scene.draw(renderer);
+        uint64_t actual = hashPixels(renderer);
+
+        if (update) {
+            std::printf("    {\"%s\", 0x%016llxull, ...},\n", scene.name, static_cast<unsigned long long>(actual));
+            continue;
+        }
+        if (actual == scene.expected) {
+            std::printf("ok      %s\n", scene.name);
+            continue;
+        }
+
+        std::string path = std::string(scene.name) + ".actual.ppm";
+        renderer.writePpm(path);
+        std::printf("FAILED  %s: hash %016llx, expected %016llx, wrote %s\n", scene.name,
+                    static_cast<unsigned long long>(actual), static_cast<unsigned long long>(scene.expected),
+                    path.c_str());
+        failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}